@@ -0,0 +1,341 @@
+#include "Micro.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+#include "Chess/Board.hpp"
+#include "Chess/Cpu.hpp"
+
+namespace
+{
+
+// Every operation is timed this many times, the median is reported and the minimum shows the noise
+constexpr std::size_t Samples = 7;
+// Iterations are doubled until one sample takes at least this long
+constexpr std::chrono::nanoseconds MinSampleTime = std::chrono::milliseconds{20};
+
+constexpr std::array<std::string_view, 6> TypeNames = {
+    "pawn", "bishop", "knight", "rook", "queen", "king"
+};
+
+struct Timing
+{
+    // Operations in one sample
+    uint64_t operations;
+    double medianNs;
+    double minNs;
+    // Over all samples, divided by operations * Samples when written
+    Profiling::PerfCounters::Reading counters;
+};
+
+struct Entry
+{
+    std::string config;
+    std::string name;
+    Timing timing;
+};
+
+// Keeps the compiler from dropping a result that is never used
+template <typename T>
+auto keep(const T& value) -> void
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// The function runs one iteration and returns how many operations it did, the timings are per operation
+template <typename Func>
+auto measure(Profiling::PerfCounters* counters, Func&& func) -> Timing
+{
+    using Clock = std::chrono::steady_clock;
+
+    auto run = [&](const uint64_t iterations) -> std::pair<Clock::duration, uint64_t>
+    {
+        uint64_t operations = 0;
+        const auto start = Clock::now();
+
+        for (uint64_t i = 0; i < iterations; i++)
+            operations += func();
+
+        return {Clock::now() - start, operations};
+    };
+
+    uint64_t iterations = 1;
+
+    while (run(iterations).first < MinSampleTime)
+        iterations *= 2;
+
+    std::array<double, Samples> samples;
+    uint64_t operations = 0;
+
+    if (counters)
+        counters->start();
+
+    for (double& sample : samples)
+    {
+        const auto [elapsed, done] = run(iterations);
+
+        sample = std::chrono::duration<double, std::nano>(elapsed).count() / done;
+        operations = done;
+    }
+
+    const Profiling::PerfCounters::Reading reading = counters ? counters->stop() : Profiling::PerfCounters::Reading{};
+
+    std::sort(samples.begin(), samples.end());
+
+    return Timing{
+        .operations = operations,
+        .medianNs = samples[Samples / 2],
+        .minNs = samples[0],
+        .counters = reading
+    };
+}
+
+// Every legal move of the side to move
+auto get_all_moves(Chess::Board& board) -> std::vector<Chess::Move>
+{
+    std::vector<Chess::Move> moves;
+    Chess::Board::MoveBuffer buffer;
+
+    for (int type = 0; type < Chess::PieceLists::KindCount / 2; type++)
+    {
+        const auto list = board.getPieceLists().get(board.getCurrentTurn(), static_cast<Chess::Piece::Type>(type));
+        const std::vector<Chess::Pos> positions(list.begin(), list.end());
+
+        for (const Chess::Pos from : positions)
+        {
+            buffer.clear();
+            board.getPossibleMoves(from, buffer);
+            moves.insert(moves.end(), buffer.begin(), buffer.end());
+        }
+    }
+
+    return moves;
+}
+
+auto bench_config(const std::string& config, std::vector<Entry>& entries, Profiling::PerfCounters* counters) -> void
+{
+    auto add = [&](const std::string_view name, const Timing& timing)
+    {
+        entries.push_back(Entry{config, std::string{name}, timing});
+    };
+
+    // Reads and parses the config, builds the move tables and publishes the first snapshot
+    add("construct", measure(counters, [&]
+    {
+        const Chess::Board board{config};
+        keep(board.getSize());
+
+        return 1;
+    }));
+
+    Chess::Board board{config};
+
+    // Everything below starts after one move, a position without history has no check or game end to find
+    if (const std::vector<Chess::Move> opening = get_all_moves(board); !opening.empty())
+        board.executeMove(opening.front());
+
+    const Chess::Pos size = board.getSize();
+    const Chess::Player turn = board.getCurrentTurn();
+    Chess::Board::TargetBuffer targets;
+
+    // Pseudo-legal targets of every piece of the type, both colors
+    for (int type = 0; type < Chess::PieceLists::KindCount / 2; type++)
+    {
+        std::vector<Chess::Pos> positions;
+
+        for (const Chess::Player color : {Chess::Player::White, Chess::Player::Black})
+        {
+            const auto list = board.getPieceLists().get(color, static_cast<Chess::Piece::Type>(type));
+            positions.insert(positions.end(), list.begin(), list.end());
+        }
+
+        if (positions.empty())
+            continue;
+
+        add(std::string{"get_moves/"} + std::string{TypeNames[type]}, measure(counters, [&]
+        {
+            for (const Chess::Pos from : positions)
+            {
+                targets.clear();
+                board.getPseudoLegalMoves(from, targets);
+                keep(targets.size());
+            }
+
+            return positions.size();
+        }));
+    }
+
+    // Every square of the board, attacked by the side that isn't to move
+    add("check_if_attacking_pos", measure(counters, [&]
+    {
+        int attacked = 0;
+
+        for (int y = 0; y < size.y; y++)
+            for (int x = 0; x < size.x; x++)
+                attacked += board.checkIfAttackingPos({x, y}, !turn);
+
+        keep(attacked);
+
+        return static_cast<uint64_t>(size.x) * size.y;
+    }));
+
+    const std::vector<Chess::Move> moves = get_all_moves(board);
+
+    if (!moves.empty())
+    {
+        // A different move every time, so the legal moves after it are never cached
+        std::size_t next = 0;
+
+        add("execute_undo", measure(counters, [&]
+        {
+            board.executeMove(moves[next]);
+            board.undoMove();
+
+            next = (next + 1) % moves.size();
+
+            return 1;
+        }));
+
+        // The same move again is a redo, its position comes back from the ply cache
+        add("execute_undo_cached", measure(counters, [&]
+        {
+            board.executeMove(moves.front());
+            board.undoMove();
+
+            return 1;
+        }));
+    }
+
+    // Legal moves of every piece of the side to move, the cache is cleared by a refresh first
+    const std::size_t pieces = board.getPieceLists().count(turn);
+
+    if (pieces != 0)
+    {
+        Chess::Board::MoveBuffer buffer;
+
+        add("get_possible_moves", measure(counters, [&]
+        {
+            board.refresh();
+
+            for (int type = 0; type < Chess::PieceLists::KindCount / 2; type++)
+            {
+                for (const Chess::Pos from : board.getPieceLists().get(turn, static_cast<Chess::Piece::Type>(type)))
+                {
+                    buffer.clear();
+                    board.getPossibleMoves(from, buffer);
+                    keep(buffer.size());
+                }
+            }
+
+            return pieces;
+        }));
+    }
+
+    add("update", measure(counters, [&]
+    {
+        board.refresh();
+
+        return 1;
+    }));
+}
+
+auto write_string(std::ostream& out, const std::string_view text) -> void
+{
+    out << '"';
+
+    for (const char c : text)
+    {
+        if (c == '"' || c == '\\')
+            out << '\\';
+
+        out << c;
+    }
+
+    out << '"';
+}
+
+// Per operation, IPC when both cycles and instructions were counted
+auto write_counters(std::ostream& out, const Timing& timing) -> void
+{
+    using Counter = Profiling::PerfCounters::Counter;
+
+    constexpr std::array<std::string_view, Profiling::PerfCounters::CounterCount> keys = {
+        "cycles", "instructions", "branch_misses", "l1_misses", "llc_misses"
+    };
+
+    const double operations = static_cast<double>(timing.operations) * Samples;
+
+    for (std::size_t i = 0; i < keys.size(); i++)
+        if (const auto value = timing.counters.values[i])
+            out << ", \"" << keys[i] << "_per_op\": " << *value / operations;
+
+    const auto cycles = timing.counters.get(Counter::Cycles);
+    const auto instructions = timing.counters.get(Counter::Instructions);
+
+    if (cycles && instructions && *cycles > 0)
+        out << ", \"ipc\": " << *instructions / *cycles;
+}
+
+} // namespace
+
+namespace Bench
+{
+
+auto run_micro_benchmarks(const std::vector<std::string>& configs, std::ostream& out, Profiling::PerfCounters* counters) -> void
+{
+    std::vector<Entry> entries;
+
+    for (const std::string& config : configs)
+        bench_config(config, entries, counters);
+
+    #ifdef DEBUG
+    constexpr bool debug = true;
+    #else
+    constexpr bool debug = false;
+    #endif
+
+    out << "{\n";
+    out << "  \"suite\": \"board\",\n";
+    out << "  \"compiler\": ";
+    write_string(out, __VERSION__);
+    out << ",\n";
+    out << "  \"debug\": " << (debug ? "true" : "false") << ",\n";
+    out << "  \"isa\": ";
+    write_string(out, Chess::isa_level_name(Chess::get_isa_level()));
+    out << ",\n";
+    out << "  \"samples\": " << Samples << ",\n";
+
+    if (counters && !counters->available())
+    {
+        out << "  \"counters_error\": ";
+        write_string(out, counters->error());
+        out << ",\n";
+    }
+
+    out << "  \"results\": [";
+
+    for (std::size_t i = 0; i < entries.size(); i++)
+    {
+        const Entry& entry = entries[i];
+
+        out << (i == 0 ? "\n" : ",\n") << "    {\"config\": ";
+        write_string(out, entry.config);
+        out << ", \"name\": ";
+        write_string(out, entry.name);
+        out << ", \"operations\": " << entry.timing.operations
+            << ", \"median_ns\": " << entry.timing.medianNs
+            << ", \"min_ns\": " << entry.timing.minNs;
+
+        write_counters(out, entry.timing);
+
+        out << "}";
+    }
+
+    out << "\n  ]\n}" << std::endl;
+}
+
+} // namespace Bench
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Profiling/PerfCounters.hpp"
+
+namespace Bench
+{
+
+// Times single Board operations on every config and writes the results as JSON, one entry per
+// operation and config, so runs on different commits can be compared by a script. With counters
+// the entries also get hardware counts per operation.
+auto run_micro_benchmarks(const std::vector<std::string>& configs, std::ostream& out, Profiling::PerfCounters* counters = nullptr) -> void;
+
+} // namespace Bench
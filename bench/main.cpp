@@ -0,0 +1,315 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Chess/Board.hpp"
+#include "Chess/Cpu.hpp"
+#include "Chess/Fill.hpp"
+#include "Chess/Magic.hpp"
+#include "Chess/Position.hpp"
+#include "Jobs/Pool.hpp"
+
+#include "Profiling/PerfCounters.hpp"
+#include "Profiling/Sampler.hpp"
+
+#include "Micro.hpp"
+
+namespace
+{
+
+// Set by --counters, every measured run is wrapped with the hardware counters then
+std::unique_ptr<Profiling::PerfCounters> counters;
+
+struct Result
+{
+    uint64_t nodes;
+    double seconds;
+    Profiling::PerfCounters::Reading counters;
+};
+
+template <typename Func>
+auto measure(Func&& func) -> Result
+{
+    if (counters)
+        counters->start();
+
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t nodes = func();
+    const auto end = std::chrono::steady_clock::now();
+
+    return Result{
+        .nodes = nodes,
+        .seconds = std::chrono::duration<double>(end - start).count(),
+        .counters = counters ? counters->stop() : Profiling::PerfCounters::Reading{}
+    };
+}
+
+auto print_result(const std::string_view name, const Result& result) -> void
+{
+    std::cout << "  " << std::left << std::setw(14) << name
+        << std::right << std::setw(12) << result.nodes << " nodes"
+        << std::setw(10) << std::fixed << std::setprecision(1) << result.seconds * 1000.0 << " ms"
+        << std::setw(8) << std::setprecision(2) << result.nodes / result.seconds / 1e6 << " Mnps\n";
+
+    if (counters)
+    {
+        std::cout << "    ";
+        Profiling::print_counters(std::cout, *counters, result.counters, result.nodes);
+        std::cout << '\n';
+    }
+}
+
+// Runs perft with both move application strategies on the same root position
+template <typename Position>
+auto compare_strategies(const Chess::Board& board, const Position& root, const int depth) -> void
+{
+    const Result copy_make = measure([&]{ return Chess::perftCopyMake(root, depth); });
+
+    Position scratch = root;
+    const Result make_unmake = measure([&]{ return Chess::perftMakeUnmake(scratch, depth); });
+
+    std::cout << "  position size " << sizeof(Position) << " bytes, depth " << depth << '\n';
+
+    print_result("copy-make", copy_make);
+    print_result("make/unmake", make_unmake);
+
+    if (copy_make.nodes != make_unmake.nodes)
+    {
+        std::cerr << "Node counts differ between strategies!" << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    const bool copy_faster = copy_make.seconds < make_unmake.seconds;
+    const double ratio = copy_faster
+        ? make_unmake.seconds / copy_make.seconds
+        : copy_make.seconds / make_unmake.seconds;
+
+    std::cout << "  faster: " << (copy_faster ? "copy-make" : "make/unmake")
+        << " (" << std::setprecision(2) << ratio << "x)\n";
+
+    // Copy-make again with the root moves spread over the pool, the counters only see this thread
+    const Result parallel = measure([&]{ return Chess::perftParallel(root, depth); });
+
+    print_result("parallel", parallel);
+
+    if (parallel.nodes != copy_make.nodes)
+    {
+        std::cerr << "Node counts differ between serial and parallel perft!" << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    std::cout << "  parallel speedup: " << std::setprecision(2)
+        << copy_make.seconds / parallel.seconds << "x on "
+        << Jobs::Pool::current()->workerCount() + 1 << " threads\n";
+
+    // Fixed size positions against the runtime sized fallback on the same board
+    if constexpr (!std::is_same_v<Position, Chess::PositionN>)
+    {
+        const Chess::PositionN generic = Chess::PositionN::fromBoard(board);
+        const Result runtime = measure([&]{ return Chess::perftCopyMake(generic, depth); });
+
+        print_result("runtime size", runtime);
+
+        std::cout << "  fixed size speedup: " << std::setprecision(2)
+            << runtime.seconds / copy_make.seconds << "x\n";
+    }
+
+    // Sliding attack lookups, the runtime sized position above walks the rays instead
+    if constexpr (Position::Standard)
+    {
+        const Chess::SliderLookup previous = Chess::get_slider_lookup();
+
+        for (const auto& [lookup, name] : {
+            std::pair{Chess::SliderLookup::Magic, "magic"},
+            std::pair{Chess::SliderLookup::Pext, "pext"}})
+        {
+            if (!Chess::set_slider_lookup(lookup))
+            {
+                std::cout << "  " << name << " not supported by the CPU\n";
+                continue;
+            }
+
+            print_result(name, measure([&]{ return Chess::perftCopyMake(root, depth); }));
+        }
+
+        Chess::set_slider_lookup(previous);
+    }
+
+    // Occluded fill kernels against the ray walk the copy-make above used, all have to agree
+    if constexpr (Position::Wide)
+    {
+        const Chess::FillKernel previous = Chess::get_fill_kernel();
+
+        for (const auto& [kernel, name] : {
+            std::pair{Chess::FillKernel::Scalar, "scalar fill"},
+            std::pair{Chess::FillKernel::Avx2, "avx2 fill"},
+            std::pair{Chess::FillKernel::Avx512, "avx512 fill"}})
+        {
+            if (!Chess::set_fill_kernel(kernel))
+            {
+                std::cout << "  " << name << " not supported by the CPU\n";
+                continue;
+            }
+
+            const Result result = measure([&]{ return Chess::perftCopyMake(root, depth); });
+
+            print_result(name, result);
+
+            if (result.nodes != copy_make.nodes)
+            {
+                std::cerr << "Node counts differ between fill kernels!" << std::endl;
+                std::exit(EXIT_FAILURE);
+            }
+        }
+
+        Chess::set_fill_kernel(previous);
+    }
+}
+
+// Filters the legal moves of every piece of the side to move both ways, the parallel path
+// has to give the same targets in the same order. Both use the same legality test, only the
+// threading differs.
+auto compare_filtering(const std::string& config) -> void
+{
+    using Filtering = Chess::Board::Filtering;
+
+    std::vector<Chess::Pos> serial_targets;
+    std::vector<Chess::Pos> parallel_targets;
+
+    for (const auto& [filtering, name, targets] : {
+        std::tuple{Filtering::Serial, "serial filter", &serial_targets},
+        std::tuple{Filtering::Parallel, "parallel filter", &parallel_targets}})
+    {
+        Chess::Board board{config};
+        board.setFiltering(filtering);
+
+        const Result result = measure([&]
+        {
+            const auto legal = board.getLegalMoves();
+            targets->assign(legal.begin(), legal.end());
+
+            return legal.size();
+        });
+
+        print_result(name, result);
+    }
+
+    if (serial_targets != parallel_targets)
+    {
+        std::cerr << "Legal moves differ between filtering modes!" << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int
+{
+    std::vector<std::string> args(argv + 1, argv + argc);
+
+    std::optional<Profiling::Sampler> sampler;
+
+    // The best kernels the CPU supports, before any thread can call them
+    Chess::init_isa_level();
+
+    // Options before the mode, in any order
+    while (!args.empty() && args.front().starts_with("--"))
+    {
+        // Hardware counters around every run, IPC and misses per node are printed with the times
+        if (args.front() == "--counters")
+            counters = std::make_unique<Profiling::PerfCounters>();
+        // Folded stacks of the whole run, written to profile.folded at the end
+        else if (args.front() == "--sample")
+            sampler.emplace();
+        // One instruction set level for everything but the kernel comparisons, the best one by default
+        else if (args.front() == "--isa" && args.size() > 1)
+        {
+            const std::optional<Chess::IsaLevel> level = Chess::parse_isa_level(args[1]);
+
+            if (!level || !Chess::set_isa_level(*level))
+            {
+                std::cerr << "Unknown or unsupported instruction set level " << args[1] << std::endl;
+                std::exit(EXIT_FAILURE);
+            }
+
+            args.erase(args.begin());
+        }
+        else
+        {
+            std::cerr << "Unknown option " << args.front() << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+
+        args.erase(args.begin());
+    }
+
+    // Single Board operations as JSON instead of the perft comparison below
+    if (!args.empty() && args.front() == "micro")
+    {
+        std::vector<std::string> configs(args.begin() + 1, args.end());
+
+        if (configs.empty())
+            configs = {
+                "res/boards/idiot.cfg",
+                "res/boards/standard.cfg",
+                "res/boards/full.cfg",
+                "res/boards/big.cfg"
+            };
+
+        Bench::run_micro_benchmarks(configs, std::cout, counters.get());
+
+        if (sampler)
+            Profiling::write_profile(*sampler);
+
+        return 0;
+    }
+
+    int depth = 4;
+    std::vector<std::string> configs{};
+
+    if (!args.empty())
+        depth = std::stoi(args.front());
+
+    for (std::size_t i = 1; i < args.size(); i++)
+        configs.push_back(args[i]);
+
+    if (configs.empty())
+        configs = {"res/boards/standard.cfg", "res/boards/big.cfg"};
+
+    // For the parallel filtering and perft, the micro benchmarks above stay on one thread
+    const Jobs::Pool pool;
+
+    for (const std::string& config : configs)
+    {
+        const Chess::Board board{config};
+        const Chess::Pos size = board.getSize();
+
+        std::cout << config << " (" << size.x << "x" << size.y << ")\n";
+
+        compare_filtering(config);
+
+        if (board.getLayout() == Chess::Board::Layout::Unsupported)
+        {
+            std::cout << "  board too big for a position, skipped\n";
+            continue;
+        }
+
+        Chess::visit_position(board, [&](const auto& root)
+        {
+            compare_strategies(board, root, depth);
+        });
+    }
+
+    if (sampler)
+        Profiling::write_profile(*sampler);
+
+    return 0;
+}
@@ -0,0 +1,594 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Chess/Board.hpp"
+#include "Chess/Cpu.hpp"
+#include "Chess/Position.hpp"
+#include "Chess/Search.hpp"
+#include "Jobs/Pool.hpp"
+#include "Profiling/Allocations.hpp"
+#include "Profiling/PerfCounters.hpp"
+#include "Profiling/Sampler.hpp"
+#include "Profiling/Stats.hpp"
+
+namespace
+{
+
+// Plies after which a game of random moves is stopped, the draw rules that would end it aren't implemented
+constexpr std::size_t MaxGamePlies = 1000;
+
+constexpr int DefaultBenchDepth = 5;
+
+// Searched by the bench command, a config and the moves played from its start
+struct BenchPosition
+{
+    std::string_view config;
+    std::vector<std::string_view> moves;
+};
+
+// Changing this list changes the bench signature
+const std::vector<BenchPosition> BenchPositions = {
+    {"res/boards/standard.cfg", {}},
+    {"res/boards/standard.cfg", {"e2e4", "e7e5", "g1f3", "b8c6", "f1c4", "g8f6"}},
+    {"res/boards/standard.cfg", {"e2e4", "d7d5", "e4d5", "d8d5", "b1c3", "d5a5"}},
+    {"res/boards/standard.cfg", {"d2d4", "g8f6", "c2c4", "e7e6", "b1c3", "f8b4", "d1c2", "e8g8"}},
+    {"res/boards/full.cfg", {}},
+    {"res/boards/test.cfg", {}},
+    {"res/boards/idiot.cfg", {}},
+    {"res/boards/big.cfg", {}},
+    {"res/boards/big.cfg", {"i2i4", "i15i13", "j1g4", "j16g13"}}
+};
+
+// Set by --counters, perft and bench then report hardware counters per node
+std::unique_ptr<Profiling::PerfCounters> counters;
+
+auto print_counters(const Profiling::PerfCounters::Reading& reading, const uint64_t nodes) -> void
+{
+    if (!counters)
+        return;
+
+    std::cout << "  ";
+    Profiling::print_counters(std::cout, *counters, reading, nodes);
+    std::cout << '\n';
+}
+
+auto print_usage(const std::string_view program) -> void
+{
+    std::cout << "Usage: " << program << " <command> [arguments]\n"
+        << "  perft <config> <depth>             count leaf nodes, positions too big for search use the board\n"
+        << "  play <config> [games] [seed]       play games of random legal moves\n"
+        << "  analyze <config> [moves...]        show the position after the moves, e.g. e2e4 e7e5\n"
+        << "  bench [depth]                      search the built-in positions, the node count is a signature\n"
+        << "Options:\n"
+        << "  --counters                         perft and bench also report hardware counters per node\n"
+        << "  --sample                           profile the command, folded stacks go to profile.folded\n"
+        << "  --stats                            print search, board and allocation counters at the end\n"
+        << "  --isa <level>                      force scalar, sse4.2, avx2 or avx512 kernels, the best supported by default\n";
+}
+
+auto parse_number(const std::string_view text) -> uint64_t
+{
+    uint64_t number = 0;
+
+    for (const char c : text)
+    {
+        if (c < '0' || c > '9')
+        {
+            std::cerr << "Expected a number, got '" << text << "'" << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+
+        number = number * 10 + (c - '0');
+    }
+
+    return number;
+}
+
+// Columns are lettered like spreadsheet columns so boards wider than 26 squares still get names
+auto column_name(const int column) -> std::string
+{
+    std::string name;
+
+    for (int x = column + 1; x > 0; x = (x - 1) / 26)
+        name.insert(name.begin(), static_cast<char>('a' + (x - 1) % 26));
+
+    return name;
+}
+
+auto square_name(const Chess::Pos pos) -> std::string
+{
+    return column_name(pos.x) + std::to_string(pos.y + 1);
+}
+
+// Reads one square from the front of the text and removes it, nullopt if there is none
+auto parse_square(std::string_view& text) -> std::optional<Chess::Pos>
+{
+    int x = 0;
+    int y = 0;
+    std::size_t i = 0;
+
+    for (; i < text.size() && text[i] >= 'a' && text[i] <= 'z'; i++)
+        x = x * 26 + (text[i] - 'a' + 1);
+
+    const std::size_t letters = i;
+
+    for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; i++)
+        y = y * 10 + (text[i] - '0');
+
+    if (letters == 0 || i == letters || y == 0)
+        return std::nullopt;
+
+    text.remove_prefix(i);
+
+    return Chess::Pos{x - 1, y - 1};
+}
+
+auto move_name(const Chess::Move& move) -> std::string
+{
+    return square_name(move.from) + square_name(move.to);
+}
+
+// Every legal move of the side to move, pieces in the order of their lists
+auto get_all_moves(Chess::Board& board, std::vector<Chess::Move>& moves) -> void
+{
+    moves.clear();
+
+    const Chess::Player color = board.getCurrentTurn();
+    Chess::Board::MoveBuffer buffer;
+
+    for (int type = 0; type < Chess::PieceLists::KindCount / 2; type++)
+    {
+        // Copied, asking for moves doesn't change the lists but keeps this independent of it
+        const auto list = board.getPieceLists().get(color, static_cast<Chess::Piece::Type>(type));
+        const std::vector<Chess::Pos> positions(list.begin(), list.end());
+
+        for (const Chess::Pos from : positions)
+        {
+            buffer.clear();
+            board.getPossibleMoves(from, buffer);
+            moves.insert(moves.end(), buffer.begin(), buffer.end());
+        }
+    }
+}
+
+// Plays moves given as two squares each, like e2e4, exits on the first one that can't be played
+auto play_moves(Chess::Board& board, const std::vector<std::string_view>& played) -> void
+{
+    std::vector<Chess::Move> moves;
+
+    for (const std::string_view name : played)
+    {
+        std::string_view text = name;
+
+        const auto from = parse_square(text);
+        const auto to = parse_square(text);
+
+        if (!from || !to || !text.empty())
+        {
+            std::cerr << "Can't read move '" << name << "', expected two squares like e2e4" << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+
+        get_all_moves(board, moves);
+
+        const auto move = std::find_if(moves.begin(), moves.end(),
+            [&](const Chess::Move& move) { return move.from == *from && move.to == *to; });
+
+        if (move == moves.end())
+        {
+            std::cerr << "Move '" << name << "' isn't legal here" << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+
+        board.executeMove(*move);
+    }
+}
+
+auto perft_board(Chess::Board& board, const int depth) -> uint64_t
+{
+    if (depth == 0)
+        return 1;
+
+    std::vector<Chess::Move> moves;
+    get_all_moves(board, moves);
+
+    if (depth == 1)
+        return moves.size();
+
+    uint64_t nodes = 0;
+
+    for (const Chess::Move& move : moves)
+    {
+        board.executeMove(move);
+        nodes += perft_board(board, depth - 1);
+        board.undoMove();
+    }
+
+    return nodes;
+}
+
+auto run_perft(const std::string& config, const int depth) -> void
+{
+    Chess::Board board{config};
+
+    if (counters)
+        counters->start();
+
+    const auto start = std::chrono::steady_clock::now();
+
+    // Counters opened with inherit only follow threads started after them, not the pool's workers
+    const uint64_t nodes = board.getLayout() == Chess::Board::Layout::Unsupported
+        ? perft_board(board, depth)
+        : Chess::visit_position(board, [&](const auto& root) {
+            return counters ? Chess::perftCopyMake(root, depth) : Chess::perftParallel(root, depth);
+        });
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const Profiling::PerfCounters::Reading reading = counters ? counters->stop() : Profiling::PerfCounters::Reading{};
+
+    std::cout << "perft " << depth << ": " << nodes << " nodes in "
+        << std::fixed << std::setprecision(1) << seconds * 1000.0 << " ms ("
+        << std::setprecision(2) << nodes / seconds / 1e6 << " Mnps)\n";
+
+    print_counters(reading, nodes);
+}
+
+struct GameResult
+{
+    Controller::GameState state{Controller::GameState::Playing};
+    std::size_t length{0};
+};
+
+// Played by one task, the board, moves and random numbers are its own
+auto play_game(const std::string& config, const uint64_t seed) -> GameResult
+{
+    using Controller::GameState;
+
+    std::mt19937_64 random{seed};
+    std::vector<Chess::Move> moves;
+
+    Chess::Board board{config};
+
+    while (board.getCurrentGameState() == GameState::Playing
+        && board.getMoveHistory().size() < MaxGamePlies)
+    {
+        get_all_moves(board, moves);
+
+        // Kings can't be captured, so a side without moves has already been flagged, but
+        // a board config without kings never ends this way
+        if (moves.empty())
+            break;
+
+        board.executeMove(moves[random() % moves.size()]);
+    }
+
+    return GameResult{board.getCurrentGameState(), board.getMoveHistory().size()};
+}
+
+auto run_games(const std::string& config, const uint64_t games, const uint64_t seed) -> void
+{
+    using Controller::GameState;
+
+    uint64_t white_wins = 0;
+    uint64_t black_wins = 0;
+    uint64_t draws = 0;
+    uint64_t unfinished = 0;
+    uint64_t plies = 0;
+
+    std::vector<GameResult> results(games);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    // Every game is seeded by its number, so the results don't depend on which thread played it
+    Jobs::parallel_for(games, 1, [&](const std::size_t begin, const std::size_t end) {
+        for (std::size_t game = begin; game < end; game++)
+            results[game] = play_game(config, seed + game);
+    });
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (std::size_t game = 0; game < games; game++)
+    {
+        const auto [state, length] = results[game];
+
+        std::cout << "game " << game + 1 << ": " << (
+            state == GameState::WhiteWin ? "white wins" :
+            state == GameState::BlackWin ? "black wins" :
+            state == GameState::Draw ? "draw" : "unfinished")
+            << " after " << length << " plies\n";
+
+        white_wins += state == GameState::WhiteWin;
+        black_wins += state == GameState::BlackWin;
+        draws += state == GameState::Draw;
+        unfinished += state == GameState::Playing;
+        plies += length;
+    }
+
+    std::cout << "white " << white_wins << ", black " << black_wins << ", draws " << draws
+        << ", unfinished " << unfinished << ", " << plies << " plies in "
+        << std::fixed << std::setprecision(1) << seconds * 1000.0 << " ms\n";
+}
+
+auto print_board(const Chess::Board& board) -> void
+{
+    constexpr std::string_view letters = "PBNRQK";
+
+    const Chess::Pos size = board.getSize();
+    const auto& pieces = board.getPieces();
+
+    for (int y = size.y - 1; y >= 0; y--)
+    {
+        std::cout << std::setw(3) << y + 1 << ' ';
+
+        for (int x = 0; x < size.x; x++)
+        {
+            const auto it = pieces.find(Chess::Pos{x, y});
+
+            if (it == pieces.end())
+            {
+                std::cout << " .";
+                continue;
+            }
+
+            const char letter = letters[static_cast<int>(it->second.type)];
+
+            std::cout << ' ' << static_cast<char>(it->second.color == Chess::Player::White
+                ? letter : letter - 'A' + 'a');
+        }
+
+        std::cout << '\n';
+    }
+
+    std::cout << "    ";
+
+    // Last letter only, the columns stay one character wide
+    for (int x = 0; x < size.x; x++)
+        std::cout << ' ' << column_name(x).back();
+
+    std::cout << '\n';
+}
+
+auto run_analysis(const std::string& config, const std::vector<std::string_view>& played) -> void
+{
+    using Controller::GameState;
+
+    Chess::Board board{config};
+    std::vector<Chess::Move> moves;
+
+    play_moves(board, played);
+
+    const Chess::Pos size = board.getSize();
+    const Chess::Player turn = board.getCurrentTurn();
+    const GameState state = board.getCurrentGameState();
+
+    print_board(board);
+
+    std::cout << "board " << size.x << "x" << size.y << ", ply " << board.getMoveHistory().size()
+        << ", " << (turn == Chess::Player::White ? "white" : "black") << " to move\n";
+
+    if (state != GameState::Playing)
+    {
+        std::cout << (
+            state == GameState::WhiteWin ? "white won" :
+            state == GameState::BlackWin ? "black won" : "draw") << '\n';
+        return;
+    }
+
+    std::vector<Chess::Pos> attackers;
+    board.getPiecesAttackingPos(board.getKingPos(turn), !turn, attackers);
+
+    if (!attackers.empty())
+    {
+        std::cout << "in check from";
+
+        for (const Chess::Pos pos : attackers)
+            std::cout << ' ' << square_name(pos);
+
+        std::cout << '\n';
+    }
+
+    get_all_moves(board, moves);
+
+    std::cout << moves.size() << " legal moves:";
+
+    for (const Chess::Move& move : moves)
+        std::cout << ' ' << move_name(move);
+
+    std::cout << '\n';
+}
+
+// Fixed depth, one thread and a cleared table for every position, so the total node count only
+// changes when the search itself does
+auto run_bench(const int depth) -> void
+{
+    Chess::TranspositionTable table;
+
+    uint64_t nodes = 0;
+    double seconds = 0.0;
+    // Summed over the positions, only the searches themselves are counted
+    Profiling::PerfCounters::Reading total;
+
+    for (const auto& [config, moves] : BenchPositions)
+    {
+        Chess::Board board{config};
+        play_moves(board, moves);
+
+        table.clear();
+
+        Chess::visit_position(board, [&](const auto& root)
+        {
+            if (counters)
+                counters->start();
+
+            const auto start = std::chrono::steady_clock::now();
+            const Chess::SearchResult result = Chess::search(root, depth, table);
+
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            nodes += result.nodes;
+
+            const Profiling::PerfCounters::Reading reading = counters ? counters->stop() : Profiling::PerfCounters::Reading{};
+
+            for (std::size_t i = 0; i < reading.values.size(); i++)
+                if (reading.values[i])
+                    total.values[i] = total.values[i].value_or(0.0) + *reading.values[i];
+
+            std::cout << config << " after " << moves.size() << " plies: ";
+
+            if (result.best)
+                std::cout << "best " << square_name(root.toPos(result.best->from))
+                    << square_name(root.toPos(result.best->to));
+            else
+                std::cout << "no move";
+
+            std::cout << ", score " << result.score << ", " << result.nodes << " nodes\n";
+
+            print_counters(reading, result.nodes);
+        });
+    }
+
+    std::cout << "depth " << depth << ", " << BenchPositions.size() << " positions\n"
+        << "Total time (ms) : " << static_cast<uint64_t>(seconds * 1000.0) << '\n'
+        << "Nodes searched  : " << nodes << '\n'
+        << "Nodes/second    : " << static_cast<uint64_t>(nodes / seconds) << '\n';
+
+    print_counters(total, nodes);
+}
+
+// Options are accepted anywhere, so they can be added to any command line
+auto take_option(std::vector<std::string_view>& args, const std::string_view option) -> bool
+{
+    const auto found = std::find(args.begin(), args.end(), option);
+
+    if (found == args.end())
+        return false;
+
+    args.erase(found);
+
+    return true;
+}
+
+// Removes the option and the value after it, nullopt if the option isn't there
+auto take_value(std::vector<std::string_view>& args, const std::string_view option) -> std::optional<std::string_view>
+{
+    const auto found = std::find(args.begin(), args.end(), option);
+
+    if (found == args.end())
+        return std::nullopt;
+
+    if (found + 1 == args.end())
+    {
+        std::cerr << "Missing value for " << option << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    const std::string_view value = *(found + 1);
+    args.erase(found, found + 2);
+
+    return value;
+}
+
+auto force_isa_level(const std::string_view name) -> void
+{
+    const std::optional<Chess::IsaLevel> level = Chess::parse_isa_level(name);
+
+    if (!level)
+    {
+        std::cerr << "Unknown instruction set level '" << name << "'" << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    if (!Chess::set_isa_level(*level))
+    {
+        std::cerr << "The CPU doesn't support " << name << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+auto run_command(const std::vector<std::string_view>& args, const char* program) -> void
+{
+    if (!args.empty() && args[0] == "bench" && args.size() <= 2)
+    {
+        run_bench(args.size() == 2 ? static_cast<int>(parse_number(args[1])) : DefaultBenchDepth);
+
+        return;
+    }
+
+    if (args.size() < 2)
+    {
+        print_usage(program);
+        std::exit(EXIT_FAILURE);
+    }
+
+    const std::string_view command = args[0];
+    const std::string config{args[1]};
+
+    if (command == "perft" && args.size() == 3)
+    {
+        run_perft(config, static_cast<int>(parse_number(args[2])));
+    }
+    else if (command == "play" && args.size() <= 4)
+    {
+        const uint64_t games = args.size() >= 3 ? parse_number(args[2]) : 1;
+        const uint64_t seed = args.size() >= 4 ? parse_number(args[3]) : std::random_device{}();
+
+        run_games(config, games, seed);
+    }
+    else if (command == "analyze")
+    {
+        run_analysis(config, std::vector<std::string_view>(args.begin() + 2, args.end()));
+    }
+    else
+    {
+        print_usage(program);
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int
+{
+    std::vector<std::string_view> args(argv + 1, argv + argc);
+
+    if (take_option(args, "--counters"))
+        counters = std::make_unique<Profiling::PerfCounters>();
+
+    std::optional<Profiling::Sampler> sampler;
+
+    if (take_option(args, "--sample"))
+        sampler.emplace();
+
+    const bool stats = take_option(args, "--stats");
+
+    // The best kernels the CPU supports, before any thread can call them
+    Chess::init_isa_level();
+
+    if (const std::optional<std::string_view> isa = take_value(args, "--isa"))
+        force_isa_level(*isa);
+
+    // Used by perft, play and the parallel move filtering of big boards
+    const Jobs::Pool pool;
+
+    run_command(args, argv[0]);
+
+    if (sampler)
+        Profiling::write_profile(*sampler);
+
+    if (stats)
+    {
+        Profiling::print_stats(std::cout, Profiling::read_stats());
+        // Board::executeMove is per move, empty unless configured with -DTRACK_ALLOCATIONS=ON
+        Profiling::print_allocation_report(std::cout);
+    }
+
+    return 0;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Chess
+{
+
+// Bump allocator for per-ply scratch data like move lists and undo records. Memory is only
+// released by frames: a frame remembers the top of the arena when it's opened and drops
+// everything allocated after it when it goes out of scope, so a search ply frees its data in O(1).
+// Debug builds also guard every allocation against writes past its end and report allocations
+// that no frame ever releases.
+class Arena
+{
+    public:
+        static constexpr std::size_t DefaultCapacity = std::size_t{4} << 20;
+
+        explicit Arena(const std::size_t capacity = DefaultCapacity);
+        ~Arena();
+
+        Arena(const Arena&) = delete;
+        auto operator=(const Arena&) -> Arena& = delete;
+
+        // Uninitialized storage for count objects, exits if the arena is full
+        template <typename T>
+        auto allocate(const std::size_t count = 1) -> T*
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "Frames never run destructors");
+
+            return static_cast<T*>(allocate_bytes(sizeof(T) * count, alignof(T)));
+        }
+
+        // Without arguments the object is default-initialized, a move list's storage is left as is
+        template <typename T, typename... Args>
+        auto create(Args&&... args) -> T&
+        {
+            if constexpr (sizeof...(Args) == 0)
+                return *::new (allocate<T>()) T;
+            else
+                return *::new (allocate<T>()) T(std::forward<Args>(args)...);
+        }
+
+        auto used() const -> std::size_t { return m_Top; }
+        auto capacity() const -> std::size_t { return m_Capacity; }
+
+        // The calling thread's arena, created on first use
+        static auto local() -> Arena&;
+
+        class Frame
+        {
+            public:
+                explicit Frame(Arena& arena = Arena::local());
+                ~Frame();
+
+                Frame(const Frame&) = delete;
+                auto operator=(const Frame&) -> Frame& = delete;
+            private:
+                Arena& m_Arena;
+                std::size_t m_Mark;
+                std::size_t m_Depth;
+        }; // class Frame
+    private:
+        std::unique_ptr<std::byte[]> m_Buffer;
+        std::size_t m_Capacity;
+        std::size_t m_Top{0};
+        std::size_t m_Depth{0};
+
+#ifdef DEBUG
+        struct Allocation
+        {
+            std::size_t offset;
+            std::size_t size;
+        };
+
+        // Live allocations, each one is followed by a guard that has to be intact on release
+        std::vector<Allocation> m_Allocations;
+
+        auto check_guards(const std::size_t mark) -> void;
+#endif
+
+        auto allocate_bytes(const std::size_t size, const std::size_t alignment) -> void*;
+        auto release(const std::size_t mark, const std::size_t depth) -> void;
+}; // class Arena
+
+} // namespace Chess
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace Chess
+{
+
+// Set of squares with one bit per square, squares are indexed as y * width + x
+template <std::size_t Bits>
+struct Bitboard
+{
+    static constexpr std::size_t WordCount = (Bits + 63) / 64;
+
+    std::array<uint64_t, WordCount> words{};
+
+    constexpr auto test(const std::size_t square) const -> bool
+    {
+        return (words[square / 64] >> (square % 64)) & 1;
+    }
+
+    constexpr auto set(const std::size_t square) -> void
+    {
+        words[square / 64] |= uint64_t{1} << (square % 64);
+    }
+
+    constexpr auto reset(const std::size_t square) -> void
+    {
+        words[square / 64] &= ~(uint64_t{1} << (square % 64));
+    }
+
+    constexpr auto any() const -> bool
+    {
+        for (const uint64_t word : words)
+            if (word)
+                return true;
+
+        return false;
+    }
+
+    constexpr auto count() const -> int
+    {
+        int result = 0;
+
+        for (const uint64_t word : words)
+            result += std::popcount(word);
+
+        return result;
+    }
+
+    // Index of the lowest set square, the board must not be empty
+    constexpr auto first() const -> std::size_t
+    {
+        std::size_t i = 0;
+
+        while (words[i] == 0)
+            i++;
+
+        return i * 64 + std::countr_zero(words[i]);
+    }
+
+    // Removes the lowest set square and returns its index
+    constexpr auto popFirst() -> std::size_t
+    {
+        std::size_t i = 0;
+
+        while (words[i] == 0)
+            i++;
+
+        const std::size_t square = i * 64 + std::countr_zero(words[i]);
+        words[i] &= words[i] - 1;
+
+        return square;
+    }
+
+    constexpr auto operator&=(const Bitboard& other) -> Bitboard&
+    {
+        for (std::size_t i = 0; i < WordCount; i++)
+            words[i] &= other.words[i];
+
+        return *this;
+    }
+
+    constexpr auto operator|=(const Bitboard& other) -> Bitboard&
+    {
+        for (std::size_t i = 0; i < WordCount; i++)
+            words[i] |= other.words[i];
+
+        return *this;
+    }
+
+    constexpr auto operator^=(const Bitboard& other) -> Bitboard&
+    {
+        for (std::size_t i = 0; i < WordCount; i++)
+            words[i] ^= other.words[i];
+
+        return *this;
+    }
+
+    friend constexpr auto operator&(Bitboard lhs, const Bitboard& rhs) -> Bitboard { return lhs &= rhs; }
+    friend constexpr auto operator|(Bitboard lhs, const Bitboard& rhs) -> Bitboard { return lhs |= rhs; }
+    friend constexpr auto operator^(Bitboard lhs, const Bitboard& rhs) -> Bitboard { return lhs ^= rhs; }
+
+    friend constexpr auto operator~(Bitboard board) -> Bitboard
+    {
+        for (uint64_t& word : board.words)
+            word = ~word;
+
+        // Keep the bits past the last square cleared
+        if constexpr (Bits % 64 != 0)
+            board.words[WordCount - 1] &= (uint64_t{1} << (Bits % 64)) - 1;
+
+        return board;
+    }
+
+    friend constexpr auto operator==(const Bitboard&, const Bitboard&) -> bool = default;
+};
+
+} // namespace Chess
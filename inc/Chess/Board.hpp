@@ -1,46 +1,164 @@
 #pragma once
 
+#include <array>
+#include <memory>
+#include <span>
 #include <string_view>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <glm/vec2.hpp>
 
 #include "Chess/Common.hpp"
+#include "Chess/FixedVector.hpp"
 #include "Chess/Piece.hpp"
+#include "Chess/PieceLists.hpp"
+#include "Chess/Snapshot.hpp"
 #include "Chess/Move.hpp"
+#include "Chess/MoveTables.hpp"
 #include "Controller/GameState.hpp"
 
 namespace Chess
 {
 
+// The game record the controller and the renderer work with, sized at runtime from the config.
+// Only the positions are specialised on the board size: search and perft convert the board with
+// visit_position(), while Board and its move generation in Figures.cpp use the runtime MoveTables.
 class Board
 {
     public:
         using PieceMap = std::unordered_map
             <Pos, Piece, PosKeyFuncs>;
-        using MoveMap = std::unordered_map
-            <Pos, std::vector<Pos>, PosKeyFuncs>;
         using MoveList = std::vector<Move>;
+
+        // Largest width or height a config may use, it bounds the move buffers below. Configs
+        // outside of it are rejected while parsing, before any buffer is filled.
+        static constexpr int MaxSide = 64;
+        // A queen on the largest board has at most (w - 1) + (h - 1) straight and as many diagonal
+        // targets, the king's 8 steps and 2 castlings are fewer
+        static constexpr std::size_t MaxPieceMoves = 4 * (MaxSide - 1);
+
+        // Caller-owned buffers for the moves of one piece, meant to live on the stack
+        using TargetBuffer = FixedVector<Pos, MaxPieceMoves>;
+        using MoveBuffer = FixedVector<Move, MaxPieceMoves>;
+
+        // How the legal moves of all pieces and the game end check are computed. Parallel splits
+        // the pieces of the side to move between worker threads, serial goes through them in turn.
+        enum class Filtering : uint8_t
+        {
+            Auto,       // parallel once the board and the side to move reach the thresholds below, with a Jobs::Pool
+            Serial,
+            Parallel
+        };
+
+        static constexpr std::size_t ParallelMinSquares = 512;
+        static constexpr std::size_t ParallelMinPieces = 64;
+        // Pieces per task of the parallel filtering
+        static constexpr std::size_t ParallelGrain = 4;
+
+        // Plies whose legal moves are kept for undo and redo
+        static constexpr std::size_t PlyCacheSize = 64;
+        // The position is saved every this many plies, a jump replays fewer moves than that
+        static constexpr std::size_t CheckpointInterval = 16;
+
+        // Position type the board is converted to for search, picked from the size in the config
+        enum class Layout : uint8_t
+        {
+            Standard,   // 8x8, Position8
+            Big,        // 16x16, Position16
+            Dynamic,    // up to 256 squares, PositionN
+            Unsupported // too big for any position
+        };
             
         Board(const std::string_view layout_file);
 
         auto getSize() const -> Pos;
         auto getPieces() const -> const PieceMap&;
+        auto getPieceLists() const -> const PieceLists&;
         auto getKingPos(Player color) const -> Pos;
         auto getCurrentTurn() const -> Player;
-        auto getPossibleMoves(const Pos from) const -> std::vector<Move>;
+        auto getPossibleMoves(const Pos from) -> std::vector<Move>;
+        auto getPossibleMoves(const Pos from, MoveBuffer& moves) -> void;
+        // Legal targets of the side to move, for one piece or for all of them. A square's targets
+        // are computed the first time they are asked for and kept until the board changes, the
+        // views stay valid until then too. Empty for squares without a piece of the side to move.
+        // Only the query for all pieces filters in parallel, one piece is always filtered alone.
+        auto getLegalMoves(const Pos from) -> std::span<const Pos>;
+        auto getLegalMoves() -> std::span<const Pos>;
+        // Targets of any piece that ignore checks to its own king, appended to the buffer
+        auto getPseudoLegalMoves(const Pos from, TargetBuffer& moves) const -> void;
+        // Stops at the first legal move found, in parallel on the boards that filter in parallel
+        auto hasAnyLegalMove() -> bool;
+        auto setFiltering(const Filtering filtering) -> void;
         auto getPiecesAttackingPos(const Pos pos, const Player color, std::vector<Pos>& attackers) const -> void;
         auto getCurrentGameState() const -> Controller::GameState;
+        auto getMoveHistory() const -> const MoveList&;
+        auto getMoveTables() const -> const MoveTables&;
+        auto getLayout() const -> Layout;
+        // Snapshots of the position for readers on other threads, a new one is published after every change
+        auto getSnapshots() const -> SnapshotChannel&;
 
         auto checkIfAttackingPos(const Pos pos, const Player color) const -> bool;
 
         auto executeMove(const Move& move) -> void;
         auto undoMove() -> Move;
+        // Plays the last undone move again, false if there is none
+        auto redoMove() -> bool;
+        // Goes to any ply of the game, played or undone, false if the game is shorter
+        auto jumpToPly(const std::size_t ply) -> bool;
         auto reset() -> void;
+        // Forgets the legal moves and finds the check and game end of the last move again, the
+        // same work a new move does. Nothing changes for the caller: it exists for the micro
+        // benchmarks, which time update() through it.
+        auto refresh() -> void;
     private:
         PieceMap m_Pieces;
-        MoveMap m_PossibleMoves;
+        // Same pieces grouped by color and type, kept in sync by execute() and undo()
+        PieceLists m_PieceLists;
+        // Targets of one square in m_LegalTargets, stale unless its epoch is the current one
+        struct LegalSlice
+        {
+            uint32_t begin;
+            uint32_t end;
+            uint32_t epoch;
+        };
+
+        // Legal targets of the side to move, a square's slice is appended when it's first asked for.
+        // Every change clears the targets and bumps the epoch.
+        std::vector<Pos> m_LegalTargets;
+        std::vector<LegalSlice> m_LegalSlices;
+        uint32_t m_LegalEpoch{1};
+        Filtering m_Filtering{Filtering::Auto};
         MoveList m_MoveHistory;
+        // Undone moves, the last one is redone first
+        MoveList m_RedoMoves;
+
+        // Legal targets and game state flags of a position that was left by a move or an undo
+        struct PlyCache
+        {
+            // History length of the position, empty for an unused entry
+            std::optional<std::size_t> ply;
+            // Type of the last move, holds the check, checkmate and stalemate flags
+            uint8_t flags;
+            std::vector<Pos> targets;
+            // Epoch is 1 for squares that were computed, 0 otherwise
+            std::vector<LegalSlice> slices;
+        };
+
+        // Ring indexed by ply, entries reuse their buffers so stepping through a game doesn't allocate
+        std::array<PlyCache, PlyCacheSize> m_PlyCache;
+
+        // Pieces of the position after a multiple of CheckpointInterval plies
+        struct Checkpoint
+        {
+            std::vector<std::pair<Pos, Piece>> pieces;
+            Pos kingWhite;
+            Pos kingBlack;
+        };
+
+        // One per interval of the game, played and undone moves, the first is the starting position
+        std::vector<Checkpoint> m_Checkpoints;
 
         Pos m_KingWhite{-1,-1};
         Pos m_KingBlack{-1,-1};
@@ -49,8 +167,16 @@ class Board
         Player m_StartingPlayer{Player::White};
         uint m_Width;
         uint m_Height;
+        Layout m_Layout;
+
+        // Knight, king and ray targets for every square, built once the size is known
+        MoveTables m_Tables;
+
+        std::unique_ptr<SnapshotChannel> m_Snapshots{std::make_unique<SnapshotChannel>()};
+        uint64_t m_SnapshotVersion{0};
 
         auto update() -> void;
+        auto publish_snapshot() -> void;
 
         auto execute(const Move& move) -> void;
         auto undo() -> Move;
@@ -60,32 +186,52 @@ class Board
             const Pos to,
             const std::optional<Piece::Type> promotion = std::nullopt) const -> Move;
 
-        auto calculate_possible_moves(const Move& move) -> void;
-        auto calculate_possible_moves_initial() -> void;
-
-        // Defined in Chess/Figures.cpp
+        auto invalidate_legal_moves() -> void;
+        auto save_ply() -> void;
+        // Restores the legal moves of the current position if they are cached, false otherwise
+        auto restore_ply() -> bool;
+        // Forgets the positions after the given ply, used when the game takes a different turn
+        auto drop_plies_after(const std::size_t ply) -> void;
+
+        auto save_checkpoint() -> void;
+        // Sets the pieces to the checkpoint at or before the ply and returns the checkpoint's ply
+        auto restore_checkpoint(const std::size_t ply) -> std::size_t;
+        auto legal_slice(const Square square) -> const LegalSlice&;
+        // Whether the move leaves the own king attacked, asked on an overlay of the board. It
+        // doesn't touch the board, so both filtering modes and several threads can use it.
+        auto is_legal_readonly(const Pos from, const Pos to) const -> bool;
+
+        auto use_parallel_filtering() const -> bool;
+        // Computes the slices of every piece of the side to move on worker threads
+        auto compute_legal_moves_parallel() -> void;
+        // Looks through the pieces of the side to move on worker threads until any of them finds
+        // a legal move, leaves the slices as they are
+        auto has_any_legal_move_parallel() const -> bool;
+
+        // Defined in Chess/Figures.cpp, pseudo-legal targets are appended to the buffer
+        auto get_moves(const Pos from, TargetBuffer& moves) const -> void;
         auto get_moves(const Pos from) const -> std::vector<Pos>;
 
         template <Piece::Type type>
-        auto get_moves_by_type(const Pos from, const Player color) const -> std::vector<Pos>;
+        auto get_moves_by_type(const Pos from, const Player color, TargetBuffer& moves) const -> void;
 }; // class Board
 
 template<>
-auto Board::get_moves_by_type<Piece::Type::Pawn>(const Pos, const Player color) const -> std::vector<Pos>;
+auto Board::get_moves_by_type<Piece::Type::Pawn>(const Pos, const Player color, TargetBuffer& moves) const -> void;
 
 template<>
-auto Board::get_moves_by_type<Piece::Type::Knight>(const Pos, const Player color) const -> std::vector<Pos>;
+auto Board::get_moves_by_type<Piece::Type::Knight>(const Pos, const Player color, TargetBuffer& moves) const -> void;
 
 template<>
-auto Board::get_moves_by_type<Piece::Type::Bishop>(const Pos, const Player color) const -> std::vector<Pos>;
+auto Board::get_moves_by_type<Piece::Type::Bishop>(const Pos, const Player color, TargetBuffer& moves) const -> void;
 
 template<>
-auto Board::get_moves_by_type<Piece::Type::Rook>(const Pos, const Player color) const -> std::vector<Pos>;
+auto Board::get_moves_by_type<Piece::Type::Rook>(const Pos, const Player color, TargetBuffer& moves) const -> void;
 
 template<>
-auto Board::get_moves_by_type<Piece::Type::Queen>(const Pos, const Player color) const -> std::vector<Pos>;
+auto Board::get_moves_by_type<Piece::Type::Queen>(const Pos, const Player color, TargetBuffer& moves) const -> void;
 
 template<>
-auto Board::get_moves_by_type<Piece::Type::King>(const Pos, const Player color) const -> std::vector<Pos>;
+auto Board::get_moves_by_type<Piece::Type::King>(const Pos, const Player color, TargetBuffer& moves) const -> void;
 
 } // namespace Chess
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
+
 #include <glm/vec2.hpp>
 
 #include "jac/type_defs.hpp"
@@ -9,6 +12,10 @@ namespace Chess
 
 using Pos = glm::vec<2, int>;
 
+// Index of a square on the board, y * width + x
+using Square = uint16_t;
+constexpr Square NoSquare = 0xFFFF;
+
 // Check if a position is within given bounds
 constexpr auto in_bounds(const Chess::Pos pos, const Chess::Pos bounds) -> bool
 {
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace Chess
+{
+
+// Instruction set levels the hot kernels are compiled for, each includes the ones before it. The
+// build itself targets no particular CPU, so the variants are compiled with target attributes and
+// the best one the CPU supports is picked by init_isa_level().
+enum class IsaLevel : uint8_t
+{
+    Scalar = 0, // plain x86-64, and anything that isn't x86-64
+    Sse42,      // SSE4.2 and POPCNT
+    Avx2,       // AVX2, BMI1 and BMI2
+    Avx512      // AVX-512 F and VL, on 256-bit registers
+};
+
+// Defined in Chess/Magic.hpp and Chess/Fill.hpp
+enum class SliderLookup : uint8_t;
+enum class FillKernel : uint8_t;
+
+// The kernel variants in use, one state for the whole program. It starts at the portable variants
+// and is only changed before any thread is started, by init_isa_level() and --isa at the top of
+// main, or by the setters in benchmarks and tests that compare the variants on one thread.
+struct Dispatch
+{
+    IsaLevel level;
+    SliderLookup sliderLookup;
+    FillKernel fillKernel;
+};
+
+// Read by the kernels on every call, written only through the setters
+extern Dispatch dispatch;
+
+// The highest level the CPU supports
+auto detect_isa_level() -> IsaLevel;
+// Switches to detect_isa_level(), every main calls this first
+auto init_isa_level() -> void;
+
+// Scalar until a level is set
+auto get_isa_level() -> IsaLevel;
+// Switches the slider lookup, the fill kernel and the search evaluation to the variants of the
+// level. Returns false and keeps the current level if the CPU doesn't support it.
+auto set_isa_level(const IsaLevel level) -> bool;
+
+// "scalar", "sse4.2", "avx2" or "avx512"
+auto isa_level_name(const IsaLevel level) -> std::string_view;
+auto parse_isa_level(const std::string_view name) -> std::optional<IsaLevel>;
+
+} // namespace Chess
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include "Chess/Bitboard.hpp"
+#include "Chess/Common.hpp"
+#include "Chess/MoveTables.hpp"
+
+namespace Chess
+{
+
+// How the sliding moves of 256-square positions are found. Walking the rays beats filling from
+// a single square on the CPUs measured so far, the fills are only used when picked explicitly.
+enum class FillKernel : uint8_t
+{
+    None = 0,   // no fills, the rays are walked square by square
+    Scalar,     // four 64-bit words at a time
+    Avx2,       // one 256-bit register
+    Avx512      // the same register, masked permutes and three-input logic from AVX-512 VL
+};
+
+// Sliding attacks on boards of up to 256 squares, computed set-wise with Kogge-Stone occluded
+// fills instead of magic tables, which would be far too large for boards like big.cfg
+class SliderFills
+{
+    public:
+        using BB = Bitboard<256>;
+
+        constexpr SliderFills(const int width, const int height)
+        {
+            // A ray is covered once the doubled shifts add up to its longest length
+            const int longest = std::max(width, height) - 1;
+
+            while ((1 << m_Steps) < longest)
+                m_Steps++;
+
+            BB board{};
+
+            for (int square = 0; square < width * height; square++)
+                board.set(square);
+
+            for (std::size_t dir = 0; dir < m_Rays.size(); dir++)
+            {
+                const Pos step = MoveTables::Steps[dir];
+                Ray& ray = m_Rays[dir];
+
+                // Squares a step can land on, a step east must not wrap to the first column of the next row
+                ray.mask = board;
+
+                if (step.x != 0)
+                    for (int y = 0; y < height; y++)
+                        ray.mask.reset(y * width + (step.x > 0 ? 0 : width - 1));
+
+                const int amount = step.y * width + step.x;
+
+                for (int k = 0; k < std::max(m_Steps, 1); k++)
+                    ray.shifts[k] = make_shift(amount * (1 << k));
+            }
+        }
+
+        // Squares attacked by any of the sliders along straight lines or diagonals, a ray stops at
+        // the first square that isn't empty (that square is included)
+        auto straight(const BB& sliders, const BB& empty) const -> BB;
+        auto diagonal(const BB& sliders, const BB& empty) const -> BB;
+
+        // Bit shift of a whole board by a signed number of squares, split into 64-bit lanes
+        struct Shift
+        {
+            // 32-bit element indices for a lane permute, lane i takes near lane nearIndex[2i] / 2
+            alignas(32) std::array<uint32_t, 8> nearIndex;
+            alignas(32) std::array<uint32_t, 8> farIndex;
+            // All ones where the source lane exists, zero where it was shifted in from outside the board
+            alignas(32) std::array<uint64_t, 4> nearKeep;
+            alignas(32) std::array<uint64_t, 4> farKeep;
+            // The keep masks as one bit per 32-bit element, for masked permutes
+            uint8_t nearElements;
+            uint8_t farElements;
+            uint64_t count;
+            // Towards higher squares
+            bool up;
+        };
+
+        struct Ray
+        {
+            BB mask;
+            // Shift by 1, 2, 4, ... steps in the ray's direction
+            std::array<Shift, 8> shifts;
+        };
+
+        auto ray(const Direction dir) const -> const Ray& { return m_Rays[static_cast<int>(dir)]; }
+        auto steps() const -> int { return m_Steps; }
+    private:
+        std::array<Ray, 8> m_Rays{};
+        int m_Steps{0};
+
+        static constexpr auto make_shift(const int amount) -> Shift
+        {
+            Shift shift{};
+
+            const int bits = amount < 0 ? -amount : amount;
+            const int lanes = bits / 64;
+
+            shift.up = amount > 0;
+            shift.count = bits % 64;
+
+            for (int i = 0; i < 4; i++)
+            {
+                const int near = shift.up ? i - lanes : i + lanes;
+                const int far = shift.up ? near - 1 : near + 1;
+
+                if (near >= 0 && near < 4)
+                {
+                    shift.nearIndex[2 * i] = 2 * near;
+                    shift.nearIndex[2 * i + 1] = 2 * near + 1;
+                    shift.nearKeep[i] = ~uint64_t{0};
+                    shift.nearElements |= 3 << (2 * i);
+                }
+
+                if (far >= 0 && far < 4)
+                {
+                    shift.farIndex[2 * i] = 2 * far;
+                    shift.farIndex[2 * i + 1] = 2 * far + 1;
+                    shift.farKeep[i] = ~uint64_t{0};
+                    shift.farElements |= 3 << (2 * i);
+                }
+            }
+
+            return shift;
+        }
+}; // class SliderFills
+
+template <int Width, int Height>
+inline constexpr SliderFills slider_fills{Width, Height};
+
+// None unless another kernel was set
+auto get_fill_kernel() -> FillKernel;
+// Returns false and keeps the current kernel if the CPU doesn't support the requested one
+auto set_fill_kernel(const FillKernel kernel) -> bool;
+auto avx2_supported() -> bool;
+auto avx512_supported() -> bool;
+
+} // namespace Chess
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <span>
+
+namespace Chess
+{
+
+// Vector with a fixed capacity and no heap allocation, meant to live on the stack
+template <typename T, std::size_t Capacity>
+class FixedVector
+{
+    public:
+        constexpr auto push_back(const T& value) -> void
+        {
+            assert(m_Size < Capacity && "FixedVector capacity exceeded");
+
+            m_Data[m_Size++] = value;
+        }
+
+        constexpr auto pop_back() -> void { m_Size--; }
+        constexpr auto clear() -> void { m_Size = 0; }
+        constexpr auto resize(const std::size_t size) -> void { m_Size = size; }
+
+        constexpr auto size() const -> std::size_t { return m_Size; }
+        constexpr auto empty() const -> bool { return m_Size == 0; }
+        static constexpr auto capacity() -> std::size_t { return Capacity; }
+
+        constexpr auto operator[](const std::size_t i) -> T& { return m_Data[i]; }
+        constexpr auto operator[](const std::size_t i) const -> const T& { return m_Data[i]; }
+
+        constexpr auto data() -> T* { return m_Data.data(); }
+        constexpr auto data() const -> const T* { return m_Data.data(); }
+
+        constexpr auto begin() -> T* { return m_Data.data(); }
+        constexpr auto end() -> T* { return m_Data.data() + m_Size; }
+        constexpr auto begin() const -> const T* { return m_Data.data(); }
+        constexpr auto end() const -> const T* { return m_Data.data() + m_Size; }
+
+        constexpr auto span() const -> std::span<const T> { return {m_Data.data(), m_Size}; }
+    private:
+        std::array<T, Capacity> m_Data;
+        std::size_t m_Size{0};
+}; // class FixedVector
+
+} // namespace Chess
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Chess/Common.hpp"
+
+namespace Chess
+{
+
+// How sliding piece attacks are looked up on 8x8 boards
+enum class SliderLookup : uint8_t
+{
+    Magic = 0,  // multiply by a magic number and shift
+    Pext        // BMI2 parallel bit extract
+};
+
+// Attacks of sliding pieces on an 8x8 board for the given occupancy, squares are y * 8 + x.
+// The tables are generated once at startup.
+auto rook_attacks(const Square square, const uint64_t occupied) -> uint64_t;
+auto bishop_attacks(const Square square, const uint64_t occupied) -> uint64_t;
+
+inline auto queen_attacks(const Square square, const uint64_t occupied) -> uint64_t
+{
+    return rook_attacks(square, occupied) | bishop_attacks(square, occupied);
+}
+
+// Magic until a level is set, PEXT from AVX2 on, see Chess/Cpu.hpp
+auto get_slider_lookup() -> SliderLookup;
+// Returns false and keeps the current lookup if the CPU doesn't support the requested one
+auto set_slider_lookup(const SliderLookup lookup) -> bool;
+auto pext_supported() -> bool;
+
+// Compares the lookups against walking the rays square by square, for every square
+// and a few thousand occupancies. Returns false on the first mismatch.
+auto validate_slider_attacks() -> bool;
+
+} // namespace Chess
@@ -1,17 +1,21 @@
 #pragma once
 
+#include <cstddef>
 #include <optional>
 #include <variant>
+#include <vector>
 
 #include "Chess/Piece.hpp"
 #include "Chess/Common.hpp"
+#include "Chess/FixedVector.hpp"
 
 namespace Chess
 {
 
 struct Move
 {
-    using SpecialMoveInfo = std::vector<std::byte>;
+    // Large enough for the biggest payload below, so creating a move never allocates
+    using SpecialMoveInfo = FixedVector<std::byte, 32>;
 
     enum class Type : uint8_t
     {
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Chess/Common.hpp"
+
+namespace Chess
+{
+
+enum class Direction : uint8_t
+{
+    North = 0,
+    NorthEast,
+    East,
+    SouthEast,
+    South,
+    SouthWest,
+    West,
+    NorthWest
+};
+
+// Walks every square of a board and reports its move lists in a fixed order: knight targets,
+// king targets, then the rays in Direction order. on_list is called before each list starts.
+template <typename OnList, typename OnTarget>
+constexpr auto visit_move_lists(const int width, const int height, OnList&& on_list, OnTarget&& on_target) -> void
+{
+    constexpr std::array<std::array<int, 2>, 8> knight_offsets = {{
+        {-1, 2}, {1, 2}, {-2, 1}, {2, 1}, {-2, -1}, {2, -1}, {-1, -2}, {1, -2}
+    }};
+
+    constexpr std::array<std::array<int, 2>, 8> steps = {{
+        {0, 1}, {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1}, {-1, 0}, {-1, 1}
+    }};
+
+    auto inside = [&](const int x, const int y) -> bool
+    {
+        return x >= 0 && x < width && y >= 0 && y < height;
+    };
+
+    for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+    {
+        // Knight
+        on_list();
+
+        for (const auto [dx, dy] : knight_offsets)
+            if (inside(x + dx, y + dy))
+                on_target(static_cast<Square>((y + dy) * width + x + dx));
+
+        // King
+        on_list();
+
+        for (const auto [dx, dy] : steps)
+            if (inside(x + dx, y + dy))
+                on_target(static_cast<Square>((y + dy) * width + x + dx));
+
+        // Rays
+        for (const auto [dx, dy] : steps)
+        {
+            on_list();
+
+            for (int nx = x + dx, ny = y + dy; inside(nx, ny); nx += dx, ny += dy)
+                on_target(static_cast<Square>(ny * width + nx));
+        }
+    }
+}
+
+// Per-square move targets for one board size, every list is already clipped to the board
+// so generators can walk them without bounds checks
+class MoveTables
+{
+    public:
+        using Direction = Chess::Direction;
+
+        static constexpr std::array<Direction, 4> Straight = {
+            Direction::North, Direction::East, Direction::South, Direction::West
+        };
+
+        static constexpr std::array<Direction, 4> Diagonal = {
+            Direction::NorthEast, Direction::SouthEast, Direction::SouthWest, Direction::NorthWest
+        };
+
+        static constexpr std::array<Pos, 8> Steps = {
+            Pos{0, 1}, Pos{1, 1}, Pos{1, 0}, Pos{1, -1},
+            Pos{0, -1}, Pos{-1, -1}, Pos{-1, 0}, Pos{-1, 1}
+        };
+
+        static constexpr int KnightList = 0;
+        static constexpr int KingList = 1;
+        static constexpr int RayLists = 2;
+        static constexpr int ListsPerSquare = RayLists + 8;
+
+        MoveTables() = default;
+        MoveTables(Pos size);
+
+        auto knight(const Square from) const -> std::span<const Square> { return list(from, KnightList); }
+        auto king(const Square from) const -> std::span<const Square> { return list(from, KingList); }
+        // Squares in the given direction ordered by distance from the square
+        auto ray(const Square from, const Direction dir) const -> std::span<const Square>
+        {
+            return list(from, RayLists + static_cast<int>(dir));
+        }
+
+        auto knight(const Pos from) const -> std::span<const Square> { return knight(toSquare(from)); }
+        auto king(const Pos from) const -> std::span<const Square> { return king(toSquare(from)); }
+        auto ray(const Pos from, const Direction dir) const -> std::span<const Square> { return ray(toSquare(from), dir); }
+
+        auto width() const -> int { return m_Width; }
+        auto squareCount() const -> std::size_t { return m_Positions.size(); }
+        // Length of all lists together
+        auto targetCount() const -> std::size_t { return m_Targets.size(); }
+        auto toPos(const Square square) const -> Pos { return m_Positions[square]; }
+        auto toSquare(const Pos pos) const -> Square { return static_cast<Square>(pos.y * m_Width + pos.x); }
+    private:
+        int m_Width{0};
+
+        // Coordinates of every square, avoids dividing by the width
+        std::vector<Pos> m_Positions;
+        // All lists back to back, list i of square s is [offsets[s * ListsPerSquare + i], offsets[... + 1])
+        std::vector<Square> m_Targets;
+        std::vector<uint32_t> m_Offsets;
+
+        auto list(const Square from, const int index) const -> std::span<const Square>
+        {
+            const uint32_t* offset = &m_Offsets[from * ListsPerSquare + index];
+
+            return {m_Targets.data() + offset[0], m_Targets.data() + offset[1]};
+        }
+}; // class MoveTables
+
+// Same lists as MoveTables for a board size known at compile time, built as a constant
+template <int Width, int Height>
+class StaticMoveTables
+{
+    public:
+        static constexpr int SquareCount = Width * Height;
+
+        constexpr StaticMoveTables()
+        {
+            std::size_t list = 0;
+            std::size_t target = 0;
+
+            visit_move_lists(Width, Height,
+                [&]{ m_Offsets[list++] = target; },
+                [&](const Square square) { m_Targets[target++] = square; });
+
+            m_Offsets[list] = target;
+        }
+
+        constexpr auto knight(const Square from) const -> std::span<const Square> { return list(from, MoveTables::KnightList); }
+        constexpr auto king(const Square from) const -> std::span<const Square> { return list(from, MoveTables::KingList); }
+        constexpr auto ray(const Square from, const Direction dir) const -> std::span<const Square>
+        {
+            return list(from, MoveTables::RayLists + static_cast<int>(dir));
+        }
+
+        static constexpr auto width() -> int { return Width; }
+        static constexpr auto toPos(const Square square) -> Pos { return Pos{square % Width, square / Width}; }
+        static constexpr auto toSquare(const Pos pos) -> Square { return static_cast<Square>(pos.y * Width + pos.x); }
+    private:
+        static constexpr auto count_targets() -> std::size_t
+        {
+            std::size_t count = 0;
+
+            visit_move_lists(Width, Height, []{}, [&](Square) { count++; });
+
+            return count;
+        }
+
+        std::array<Square, count_targets()> m_Targets{};
+        std::array<uint16_t, SquareCount * MoveTables::ListsPerSquare + 1> m_Offsets{};
+
+        constexpr auto list(const Square from, const int index) const -> std::span<const Square>
+        {
+            const uint16_t* offset = &m_Offsets[from * MoveTables::ListsPerSquare + index];
+
+            return {m_Targets.data() + offset[0], m_Targets.data() + offset[1]};
+        }
+}; // class StaticMoveTables
+
+template <int Width, int Height>
+inline constexpr StaticMoveTables<Width, Height> static_move_tables{};
+
+} // namespace Chess
@@ -1,11 +1,7 @@
 #pragma once
 
-#include <vector>
-
 #include "Chess/Common.hpp"
 
-#include "Renderer/Mesh.hpp"
-
 namespace Chess
 {
 
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <span>
+#include <vector>
+
+#include "Chess/Common.hpp"
+#include "Chess/Piece.hpp"
+
+namespace Chess
+{
+
+// Squares of the pieces of every color and type, each kind stored contiguously. Every occupied
+// square keeps its index in its list, so adding, removing and moving a piece are O(1).
+class PieceLists
+{
+    public:
+        static constexpr int KindCount = 12;
+
+        PieceLists() = default;
+        PieceLists(const Pos size) : m_Width{size.x}, m_Index(size.x * size.y, 0) {}
+
+        auto add(const Pos pos, const Piece piece) -> void
+        {
+            std::vector<Pos>& list = m_Lists[kind(piece)];
+
+            m_Index[square(pos)] = list.size();
+            list.push_back(pos);
+        }
+
+        // The last piece of the list takes the place of the removed one
+        auto remove(const Pos pos, const Piece piece) -> void
+        {
+            std::vector<Pos>& list = m_Lists[kind(piece)];
+            const Square index = m_Index[square(pos)];
+
+            list[index] = list.back();
+            m_Index[square(list[index])] = index;
+            list.pop_back();
+        }
+
+        auto move(const Pos from, const Pos to, const Piece piece) -> void
+        {
+            const Square index = m_Index[square(from)];
+
+            m_Lists[kind(piece)][index] = to;
+            m_Index[square(to)] = index;
+        }
+
+        auto clear() -> void
+        {
+            for (std::vector<Pos>& list : m_Lists)
+                list.clear();
+        }
+
+        auto get(const Player color, const Piece::Type type) const -> std::span<const Pos>
+        {
+            return m_Lists[kind(Piece{.color = color, .type = type})];
+        }
+
+        auto count(const Player color) const -> std::size_t
+        {
+            std::size_t pieces = 0;
+
+            for (int type = 0; type < KindCount / 2; type++)
+                pieces += get(color, static_cast<Piece::Type>(type)).size();
+
+            return pieces;
+        }
+    private:
+        int m_Width{0};
+        std::vector<Square> m_Index;
+        std::array<std::vector<Pos>, KindCount> m_Lists;
+
+        static auto kind(const Piece piece) -> int
+        {
+            return static_cast<int>(piece.color) * (KindCount / 2) + static_cast<int>(piece.type);
+        }
+
+        auto square(const Pos pos) const -> Square { return static_cast<Square>(pos.y * m_Width + pos.x); }
+}; // class PieceLists
+
+} // namespace Chess
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "Chess/Bitboard.hpp"
+#include "Chess/Board.hpp"
+#include "Chess/Common.hpp"
+#include "Chess/Fill.hpp"
+#include "Chess/FixedVector.hpp"
+#include "Chess/MoveTables.hpp"
+#include "Chess/Piece.hpp"
+
+namespace Chess
+{
+
+// Compact move used by the positions, it carries just enough to be applied without a lookup
+struct PackedMove
+{
+    enum Flag : uint8_t
+    {
+        Quiet = 0,
+        Capture = 1 << 0,
+        Promotion = 1 << 1,
+        Castling = 1 << 2,
+        DoublePush = 1 << 3,
+        EnPassant = 1 << 4
+    };
+
+    Square from;
+    Square to;
+    uint8_t promotion; // Piece::Type, valid only with Promotion flag
+    uint8_t flags;
+
+    auto isFlag(Flag flag) const -> bool { return (flags & flag) != 0; }
+};
+
+// Width and height value for positions whose size is only known at runtime
+constexpr int Dynamic = 0;
+
+// Board dimensions and move tables of a position, compile-time constants when the size is fixed
+template <int Width, int Height>
+struct PositionGeometry
+{
+    static constexpr std::size_t Squares = Width * Height;
+    // 8x8 boards look sliding attacks up instead of walking the rays
+    static constexpr bool Standard = Width == 8 && Height == 8;
+    // 256-square boards can fill sliding attacks set-wise instead, see FillKernel
+    static constexpr bool Wide = Squares == 256;
+
+    static constexpr auto fits(const Pos size) -> bool { return size.x == Width && size.y == Height; }
+
+    static constexpr auto width() -> int { return Width; }
+    static constexpr auto height() -> int { return Height; }
+    static constexpr auto tables() -> const StaticMoveTables<Width, Height>& { return static_move_tables<Width, Height>; }
+    static constexpr auto fills() -> const SliderFills& { return slider_fills<Width, Height>; }
+
+    constexpr auto setGeometry(const Board& /* board */) -> void {}
+};
+
+// Runtime sized fallback, holds up to 256 squares and borrows the move tables of the board
+template <>
+struct PositionGeometry<Dynamic, Dynamic>
+{
+    static constexpr std::size_t Squares = 256;
+    static constexpr bool Standard = false;
+    static constexpr bool Wide = false;
+
+    static constexpr auto fits(const Pos size) -> bool
+    {
+        return size.x > 0 && size.y > 0 && static_cast<std::size_t>(size.x * size.y) <= Squares;
+    }
+
+    auto width() const -> int { return m_Width; }
+    auto height() const -> int { return m_Height; }
+    auto tables() const -> const MoveTables& { return *m_Tables; }
+
+    auto setGeometry(const Board& board) -> void
+    {
+        m_Tables = &board.getMoveTables();
+        m_Width = board.getSize().x;
+        m_Height = board.getSize().y;
+    }
+
+    const MoveTables* m_Tables;
+    uint16_t m_Width;
+    uint16_t m_Height;
+};
+
+// Trivially copyable snapshot of a game for search and worker threads. Moves can be
+// applied in place with make/unmake, or by copy with after().
+template <int Width, int Height>
+struct BasicPosition : PositionGeometry<Width, Height>
+{
+    using Geometry = PositionGeometry<Width, Height>;
+    using Geometry::Squares;
+    using Geometry::width;
+    using Geometry::height;
+    using Geometry::tables;
+
+    using BB = Bitboard<Squares>;
+
+    static constexpr std::size_t MaxMoves = Squares <= 64 ? 256 : 1024;
+
+    using MoveList = FixedVector<PackedMove, MaxMoves>;
+
+    // Everything make() overwrites and unmake() needs back
+    struct Undo
+    {
+        uint64_t hash;
+        BB unmoved;
+        Square enPassant;
+        Square rookFrom;
+        uint16_t halfmoveClock;
+        uint8_t captured;
+        uint8_t checked;
+    };
+
+    // Piece codes, 0 is an empty square, otherwise 1 + type + 6 * color
+    std::array<uint8_t, Squares> squares;
+    // Indexed by color * 6 + type
+    std::array<BB, 12> pieces;
+    std::array<BB, 2> colors;
+    // Pieces that have not moved yet (pawn double step, castling)
+    BB unmoved;
+
+    uint64_t hash;
+
+    std::array<Square, 2> kings;
+    // Pawn that can be captured en passant, NoSquare if none
+    Square enPassant;
+    uint16_t halfmoveClock;
+    uint16_t ply;
+
+    Player side;
+    // Bit per color, set once that color was put in check (it can't castle anymore)
+    uint8_t checked;
+
+    static auto fromBoard(const Board& board) -> BasicPosition;
+
+    auto toSquare(const Pos pos) const -> Square { return static_cast<Square>(pos.y * width() + pos.x); }
+    auto toPos(const Square square) const -> Pos { return Pos{square % width(), square / width()}; }
+
+    // Pseudo-legal moves for the side to move, they may leave the own king attacked
+    auto generateMoves(MoveList& moves) const -> void;
+    auto generateLegalMoves(MoveList& moves) const -> void;
+
+    auto isAttacked(const Square square, const Player by) const -> bool;
+    // True if the side that just moved left its king attacked
+    auto leftKingAttacked() const -> bool { return isAttacked(kings[static_cast<int>(!side)], side); }
+
+    auto make(const PackedMove& move) -> void;
+    auto make(const PackedMove& move, Undo& undo) -> void;
+    auto unmake(const PackedMove& move, const Undo& undo) -> void;
+
+    // Copy-make, the position itself is left untouched
+    auto after(const PackedMove& move) const -> BasicPosition
+    {
+        BasicPosition next = *this;
+        next.make(move);
+        return next;
+    }
+};
+
+// Explicitly instantiated in Position.cpp
+using Position8 = BasicPosition<8, 8>;
+using Position16 = BasicPosition<16, 16>;
+using PositionN = BasicPosition<Dynamic, Dynamic>;
+
+static_assert(std::is_trivially_copyable_v<Position8>);
+static_assert(std::is_trivially_copyable_v<Position16>);
+static_assert(std::is_trivially_copyable_v<PositionN>);
+
+// Counts leaf nodes of the legal move tree, the two variants differ only in how moves are applied
+template <typename Position>
+auto perftCopyMake(const Position& position, const int depth) -> uint64_t;
+
+template <typename Position>
+auto perftMakeUnmake(Position& position, const int depth) -> uint64_t;
+
+// perftCopyMake with the subtrees of the root moves spread over the current Jobs::Pool
+template <typename Position>
+auto perftParallel(const Position& position, const int depth) -> uint64_t;
+
+// Converts the board to the position type picked for its layout when the config was parsed,
+// and calls func with it. The layout must not be Board::Layout::Unsupported.
+template <typename Func>
+auto visit_position(const Board& board, Func&& func) -> decltype(auto)
+{
+    switch (board.getLayout())
+    {
+        case Board::Layout::Standard:
+            return func(Position8::fromBoard(board));
+        case Board::Layout::Big:
+            return func(Position16::fromBoard(board));
+        default:
+            return func(PositionN::fromBoard(board));
+    }
+}
+
+} // namespace Chess
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "Chess/Position.hpp"
+
+namespace Chess
+{
+
+// Scores are in centipawns from the view of the side to move, mates are MateScore minus the
+// plies to reach them
+constexpr int MateScore = 30000;
+constexpr int InfiniteScore = 32000;
+
+// Scores and best moves of positions seen during a search, keyed by the position hash. One
+// table per searching thread, entries are simply replaced when two positions share a slot.
+class TranspositionTable
+{
+    public:
+        static constexpr std::size_t DefaultMegabytes = 16;
+
+        enum class Bound : uint8_t
+        {
+            Exact,
+            Lower,  // the score is at least this, the search failed high
+            Upper   // the score is at most this, no move raised alpha
+        };
+
+        struct Entry
+        {
+            uint64_t key;
+            PackedMove move;
+            int16_t score;
+            int8_t depth;
+            Bound bound;
+        };
+
+        // Rounded down to a power of two entries
+        explicit TranspositionTable(const std::size_t megabytes = DefaultMegabytes);
+
+        auto clear() -> void;
+        // nullptr unless the slot holds this very position
+        auto probe(const uint64_t key) const -> const Entry*;
+        auto store(const Entry& entry) -> void;
+    private:
+        std::vector<Entry> m_Entries;
+        uint64_t m_Mask;
+}; // class TranspositionTable
+
+struct SearchResult
+{
+    // Empty if the side to move has no legal move
+    std::optional<PackedMove> best;
+    int score;
+    uint64_t nodes;
+};
+
+// Alpha-beta to a fixed depth with iterative deepening, captures are searched until the position
+// is quiet. Single threaded and deterministic: the same position, depth and a cleared table
+// always visit the same nodes.
+template <typename Position>
+auto search(const Position& root, const int depth, TranspositionTable& table) -> SearchResult;
+
+} // namespace Chess
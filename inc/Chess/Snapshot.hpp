@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "Chess/Common.hpp"
+#include "Chess/Move.hpp"
+#include "Chess/Piece.hpp"
+#include "Chess/PieceLists.hpp"
+#include "Controller/GameState.hpp"
+
+namespace Chess
+{
+
+// Immutable copy of a position, Board publishes a new one after every change
+struct Snapshot
+{
+    // Increases with every published snapshot
+    uint64_t version;
+
+    Pos size;
+    Player turn;
+    Controller::GameState state;
+    std::size_t ply;
+    std::optional<Move> lastMove;
+    std::array<Pos, 2> kings;
+
+    // Grouped by color and type in the same order as PieceLists
+    std::vector<std::pair<Pos, Piece>> pieces;
+    std::array<uint32_t, PieceLists::KindCount + 1> kindBegin;
+
+    auto get(const Player color, const Piece::Type type) const -> std::span<const std::pair<Pos, Piece>>
+    {
+        const int kind = static_cast<int>(color) * (PieceLists::KindCount / 2) + static_cast<int>(type);
+
+        return {pieces.data() + kindBegin[kind], pieces.data() + kindBegin[kind + 1]};
+    }
+
+    auto pieceAt(const Pos pos) const -> std::optional<Piece>;
+}; // struct Snapshot
+
+// Hands snapshots from one writer to readers on any thread. Readers never take a lock and the
+// writer never waits for them: a replaced snapshot is retired and only freed once every reader
+// has moved past the epoch it was replaced in.
+class SnapshotChannel
+{
+    public:
+        static constexpr std::size_t MaxReaders = 16;
+
+        SnapshotChannel() = default;
+        ~SnapshotChannel();
+
+        SnapshotChannel(const SnapshotChannel&) = delete;
+        auto operator=(const SnapshotChannel&) -> SnapshotChannel& = delete;
+
+        // Writer only
+        auto publish(std::unique_ptr<const Snapshot> snapshot) -> void;
+
+        // One per reading thread, holds one of the MaxReaders slots while it exists
+        class Reader
+        {
+            public:
+                explicit Reader(SnapshotChannel& channel);
+                ~Reader();
+
+                Reader(const Reader&) = delete;
+                auto operator=(const Reader&) -> Reader& = delete;
+
+                // Keeps the snapshot alive until it goes out of scope, one view per reader at a time
+                class View
+                {
+                    public:
+                        View(const Snapshot* snapshot, std::atomic<uint64_t>& epoch) :
+                            m_Snapshot{snapshot}, m_Epoch{epoch} {}
+                        ~View() { m_Epoch.store(0); }
+
+                        View(const View&) = delete;
+                        auto operator=(const View&) -> View& = delete;
+
+                        auto operator->() const -> const Snapshot* { return m_Snapshot; }
+                        auto operator*() const -> const Snapshot& { return *m_Snapshot; }
+                    private:
+                        const Snapshot* m_Snapshot;
+                        std::atomic<uint64_t>& m_Epoch;
+                }; // class View
+
+                auto read() const -> View;
+            private:
+                SnapshotChannel& m_Channel;
+                std::size_t m_Slot;
+        }; // class Reader
+    private:
+        std::atomic<const Snapshot*> m_Current{nullptr};
+        std::atomic<uint64_t> m_Epoch{1};
+
+        // Epoch a reader saw when it started reading, 0 while it isn't
+        std::array<std::atomic<uint64_t>, MaxReaders> m_ReaderEpochs{};
+        std::array<std::atomic<bool>, MaxReaders> m_ReaderSlots{};
+
+        // Replaced snapshots and the epoch they were replaced in, only touched by the writer
+        std::vector<std::pair<const Snapshot*, uint64_t>> m_Retired;
+
+        auto reclaim() -> void;
+}; // class SnapshotChannel
+
+} // namespace Chess
@@ -1,13 +1,17 @@
 #pragma once
 
+#include <array>
 #include <map>
 #include <functional>
+#include <span>
 
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
 
 #include "Renderer/Camera.hpp"
 #include "Chess/Board.hpp"
+#include "Controller/FrameState.hpp"
+#include "Controller/TripleBuffer.hpp"
 
 namespace Controller
 {
@@ -15,18 +19,21 @@ namespace Controller
 class Controller
 {
     public:
-        Controller(Renderer::Camera& camera, Chess::Board& board, GLFWwindow* window) noexcept;
-        auto update() noexcept -> void;
+        Controller(Chess::Board& board, GLFWwindow* window) noexcept;
 
-        auto getFocusedPiece() const noexcept -> const std::optional<Chess::Pos>& { return m_FocusedSquare; }
-        auto getSelectedPiece() const noexcept -> const std::optional<Chess::Pos>& { return m_SelectedSquare; }
-        auto getAttackingPieces() const noexcept -> const std::vector<Chess::Pos>& { return m_AttackingPieces; }
-        
-        auto getPossibleMoves() const noexcept -> const std::vector<Chess::Move>& { return m_PossibleMoves; }
+        // Main thread, GLFW only allows polling the keyboard and mouse there
+        auto captureInput() noexcept -> void;
+        // Logic thread, handles the latest input and publishes a frame. Sleeps for a moment
+        // when nothing new was captured.
+        auto update() noexcept -> void;
+        // Main thread, the latest frame published by update()
+        auto getFrame() noexcept -> const FrameState&;
     private:
-        Renderer::Camera& m_Camera;
+        Renderer::Camera m_Camera;
         Chess::Board& m_Board;
         GLFWwindow* m_Window;
+        // The controller changes the board, but reads it through snapshots like everyone else
+        Chess::SnapshotChannel::Reader m_Snapshots;
 
         using Key = int;
         using KeyState = int;
@@ -46,16 +53,46 @@ class Controller
             UnselectPiece,
 
             UndoMove,
-            ResetBoard
+            RedoMove,
+            ResetBoard,
+
+            // Writes the trace zones recorded so far, with -DENABLE_TRACING=ON
+            DumpTrace
         };
 
-        std::map<Key, KeyState> m_Keys;
+        static constexpr std::size_t MaxKeys = 16;
+
+        // Key presses and left clicks are counted since the start, so none is lost when the
+        // logic thread is busy for a few frames
+        struct Input
+        {
+            glm::dvec2 cursor;
+            glm::ivec2 windowSize;
+            std::array<uint32_t, MaxKeys> keyPresses;
+            uint32_t clicks;
+        };
+
+        // Set up in the constructor, read-only afterwards
         std::map<Key, Action> m_KeyActions;
 
+        // Main thread only
+        std::array<KeyState, MaxKeys> m_KeyStates{};
+        std::array<uint32_t, MaxKeys> m_KeyPresses{};
+        KeyState m_MouseState{GLFW_RELEASE};
+        uint32_t m_Clicks{0};
+
+        // Logic thread only
+        std::array<uint32_t, MaxKeys> m_HandledKeyPresses{};
+        uint32_t m_HandledClicks{0};
+        double m_GameOverTime{0.0};
+
+        TripleBuffer<Input> m_Inputs;
+        TripleBuffer<FrameState> m_Frames;
+
         std::optional<Chess::Pos> m_FocusedSquare{std::nullopt};
         std::optional<Chess::Pos> m_SelectedSquare{std::nullopt};
         std::vector<Chess::Pos> m_AttackingPieces{};
-        std::vector<Chess::Move> m_PossibleMoves{};
+        std::span<const Chess::Pos> m_PossibleMoves{};
 
         struct CameraSetup {
             glm::vec3 position;
@@ -71,10 +108,12 @@ class Controller
 
         auto update_camera() noexcept -> void;
 
-        auto handle_mouse_move() noexcept -> void;
+        auto publish_frame() noexcept -> void;
+
+        auto handle_mouse_move(const Input& input) noexcept -> void;
 
-        auto handle_keyboard() noexcept -> Action;
-        auto handle_mouse_click() noexcept -> Action;
+        auto handle_keyboard(const Input& input) noexcept -> void;
+        auto handle_mouse_click(const Input& input) noexcept -> void;
 
         auto handle_action(Action action) noexcept -> void;
 
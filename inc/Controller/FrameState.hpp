@@ -0,0 +1,34 @@
+#pragma once
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "Chess/Common.hpp"
+#include "Chess/Piece.hpp"
+#include "Controller/GameState.hpp"
+#include "Renderer/Camera.hpp"
+
+namespace Controller
+{
+
+// Everything the renderer needs for one frame, copied out by the logic thread so the render
+// thread never touches the board
+struct FrameState
+{
+    Renderer::Camera camera;
+
+    // Grouped by color and type, so the same model is drawn in a row
+    std::vector<std::pair<Chess::Pos, Chess::Piece>> pieces;
+
+    std::optional<Chess::Pos> focused;
+    std::optional<Chess::Pos> selected;
+    std::vector<Chess::Pos> possibleMoves;
+    std::vector<Chess::Pos> attackingPieces;
+
+    GameState state{GameState::Playing};
+    // glfwGetTime() when the game ended, the game over screen fades in from there
+    double gameOverTime{0.0};
+};
+
+} // namespace Controller
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace Controller
+{
+
+// Hands the latest value from one writer thread to one reader thread without locks. The writer
+// fills the back buffer and publishes it, the reader picks up the newest published one. Neither
+// side waits for the other, values published in between are skipped.
+template <typename T>
+class TripleBuffer
+{
+    public:
+        // Writer, the back buffer holds an older value and has to be filled completely
+        auto back() -> T& { return m_Buffers[m_Back]; }
+
+        auto publish() -> void
+        {
+            m_Back = m_Middle.exchange(m_Back | Fresh, std::memory_order_acq_rel) & IndexMask;
+        }
+
+        // Reader, takes the newest published value if there is one, false if nothing changed
+        auto update() -> bool
+        {
+            if (!(m_Middle.load(std::memory_order_relaxed) & Fresh))
+                return false;
+
+            m_Front = m_Middle.exchange(m_Front, std::memory_order_acq_rel) & IndexMask;
+
+            return true;
+        }
+
+        auto front() const -> const T& { return m_Buffers[m_Front]; }
+    private:
+        static constexpr uint8_t IndexMask = 0b11;
+        // Set while the middle buffer hasn't been taken by the reader
+        static constexpr uint8_t Fresh = 0b100;
+
+        std::array<T, 3> m_Buffers{};
+
+        std::atomic<uint8_t> m_Middle{1};
+        uint8_t m_Back{0};
+        uint8_t m_Front{2};
+}; // class TripleBuffer
+
+} // namespace Controller
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Jobs
+{
+
+class TaskGroup;
+
+struct Task
+{
+    std::function<void()> function;
+    TaskGroup* group;
+};
+
+// The thread pool of the process. Whoever owns one (the main() of each executable) makes it
+// current, TaskGroup and parallel_for use the current one and run serially without it, so
+// libraries never start threads of their own. Every worker has a Chase-Lev deque: it pushes and
+// pops its own tasks at the bottom, idle workers steal from the top. Tasks from threads outside
+// the pool go through a shared queue.
+class Pool
+{
+    public:
+        // One thread per core besides the one that creates the pool
+        explicit Pool(const std::size_t workers = std::max(std::thread::hardware_concurrency(), 2u) - 1);
+        ~Pool();
+
+        Pool(const Pool&) = delete;
+        auto operator=(const Pool&) -> Pool& = delete;
+
+        auto workerCount() const -> std::size_t;
+
+        // The first pool that was created and still lives, nullptr if there is none
+        static auto current() -> Pool*;
+
+        auto submit(Task& task) -> void;
+        // Runs one queued task on the calling thread, false if there was none. Threads waiting for
+        // a group call this, so a group never waits on tasks nobody is free to run.
+        auto runOne() -> bool;
+    private:
+        class Deque;
+
+        std::vector<std::unique_ptr<Deque>> m_Deques;
+        std::vector<std::thread> m_Workers;
+
+        std::mutex m_SharedMutex;
+        std::deque<Task*> m_Shared;
+
+        // Workers sleep on this once there is nothing to steal, every submit bumps the epoch
+        std::mutex m_SleepMutex;
+        std::condition_variable m_Wake;
+        std::atomic<uint64_t> m_Epoch{0};
+        std::atomic<int> m_Sleeping{0};
+        bool m_Stopping{false};
+
+        auto worker_loop(const std::size_t index) -> void;
+        auto take(const std::size_t own) -> Task*;
+        auto wake() -> void;
+}; // class Pool
+
+// Tasks started by one thread and waited for together. Tasks may start groups of their own, a
+// thread waiting for its group runs other tasks meanwhile. Tasks must not throw.
+class TaskGroup
+{
+    public:
+        explicit TaskGroup(Pool* pool = Pool::current()) noexcept;
+        // Waits, a group never outlives its tasks
+        ~TaskGroup();
+
+        TaskGroup(const TaskGroup&) = delete;
+        auto operator=(const TaskGroup&) -> TaskGroup& = delete;
+
+        // Only from the thread that created the group, runs right away without a pool
+        template <typename Function>
+        auto run(Function&& function) -> void
+        {
+            if (!m_Pool)
+            {
+                function();
+                return;
+            }
+
+            m_Pending.fetch_add(1, std::memory_order_relaxed);
+            m_Tasks.push_back(Task{std::forward<Function>(function), this});
+            m_Pool->submit(m_Tasks.back());
+        }
+
+        auto wait() -> void;
+
+        // Called by the pool after a task of the group ran
+        auto finish() noexcept -> void;
+    private:
+        Pool* m_Pool;
+        // A deque never moves its elements, the pool holds pointers to them
+        std::deque<Task> m_Tasks;
+        std::atomic<std::size_t> m_Pending{0};
+}; // class TaskGroup
+
+// Calls function(begin, end) on consecutive chunks of [0, count) of at least grain elements,
+// spread over the current pool and the calling thread. Returns when all chunks are done.
+template <typename Function>
+auto parallel_for(const std::size_t count, const std::size_t grain, Function&& function) -> void
+{
+    Pool* pool = Pool::current();
+
+    if (!pool || count <= grain)
+    {
+        if (count > 0)
+            function(std::size_t{0}, count);
+
+        return;
+    }
+
+    // A few chunks per thread, so the ones that finish early can steal the rest
+    const std::size_t threads = pool->workerCount() + 1;
+    const std::size_t chunk = std::max(grain, (count + threads * 4 - 1) / (threads * 4));
+
+    TaskGroup group{pool};
+
+    for (std::size_t begin = chunk; begin < count; begin += chunk)
+        group.run([&function, begin, end = std::min(begin + chunk, count)] { function(begin, end); });
+
+    function(std::size_t{0}, std::min(chunk, count));
+
+    group.wait();
+}
+
+} // namespace Jobs
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+#include "Profiling/Macros.hpp"
+
+namespace Profiling
+{
+
+// Set by configuring with -DTRACK_ALLOCATIONS=ON, which replaces the global operator new. The
+// macros below compile to nothing otherwise.
+#ifdef CHESS_TRACK_ALLOCATIONS
+constexpr bool AllocationTrackingEnabled = true;
+#else
+constexpr bool AllocationTrackingEnabled = false;
+#endif
+
+struct AllocationCounts
+{
+    uint64_t allocations{0};
+    uint64_t bytes{0};
+};
+
+// Everything the calling thread allocated since it started, zero without tracking
+auto thread_allocations() -> AllocationCounts;
+
+// One per PROFILE_ALLOCATIONS in the code, a function local static registered on first use.
+// Every pass through the scope adds what the thread allocated in it.
+class AllocationSite
+{
+    public:
+        explicit AllocationSite(const char* name) noexcept;
+
+        AllocationSite(const AllocationSite&) = delete;
+        auto operator=(const AllocationSite&) -> AllocationSite& = delete;
+
+        auto add(const AllocationCounts& counts) noexcept -> void;
+
+        auto name() const -> const char* { return m_Name; }
+        auto calls() const -> uint64_t { return m_Calls.load(std::memory_order_relaxed); }
+        auto allocations() const -> uint64_t { return m_Allocations.load(std::memory_order_relaxed); }
+        auto bytes() const -> uint64_t { return m_Bytes.load(std::memory_order_relaxed); }
+        auto next() const -> const AllocationSite* { return m_Next; }
+    private:
+        const char* m_Name;
+        std::atomic<uint64_t> m_Calls{0};
+        std::atomic<uint64_t> m_Allocations{0};
+        std::atomic<uint64_t> m_Bytes{0};
+        // Sites form a list that is only ever prepended to
+        const AllocationSite* m_Next{nullptr};
+}; // class AllocationSite
+
+class AllocationScope
+{
+    public:
+        explicit AllocationScope(AllocationSite& site) noexcept;
+        ~AllocationScope();
+
+        AllocationScope(const AllocationScope&) = delete;
+        auto operator=(const AllocationScope&) -> AllocationScope& = delete;
+    private:
+        AllocationSite& m_Site;
+        AllocationCounts m_Start;
+}; // class AllocationScope
+
+// Any allocation of the thread while one is alive prints the name of the innermost one and
+// aborts, so a debugger or the core dump shows the allocating call
+class NoAllocationScope
+{
+    public:
+        explicit NoAllocationScope(const char* name) noexcept;
+        ~NoAllocationScope();
+
+        NoAllocationScope(const NoAllocationScope&) = delete;
+        auto operator=(const NoAllocationScope&) -> NoAllocationScope& = delete;
+    private:
+        const char* m_Outer;
+}; // class NoAllocationScope
+
+// Calls, allocations and bytes per call of every site, sites with the same name are summed.
+// Prints nothing without tracking.
+auto print_allocation_report(std::ostream& out) -> void;
+
+} // namespace Profiling
+
+#ifdef CHESS_TRACK_ALLOCATIONS
+#define PROFILE_ALLOCATIONS(name) \
+    static ::Profiling::AllocationSite PROFILE_CONCAT(allocation_site_, __LINE__){name}; \
+    const ::Profiling::AllocationScope PROFILE_CONCAT(allocation_scope_, __LINE__){PROFILE_CONCAT(allocation_site_, __LINE__)}
+#define ASSERT_NO_ALLOCATIONS(name) const ::Profiling::NoAllocationScope PROFILE_CONCAT(no_allocation_scope_, __LINE__){name}
+#else
+#define PROFILE_ALLOCATIONS(name) static_cast<void>(0)
+#define ASSERT_NO_ALLOCATIONS(name) static_cast<void>(0)
+#endif
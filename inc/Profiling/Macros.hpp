@@ -0,0 +1,6 @@
+#pragma once
+
+// Pastes __LINE__ into the names of the objects the PROFILE_ macros declare, so several of them
+// fit into one scope
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+
+namespace Profiling
+{
+
+// Hardware counters of the calling thread and the threads it starts afterwards, read through
+// Linux perf_event_open. Counters the kernel or the container doesn't allow stay closed and
+// read as empty, so the tools still run with wall clock numbers only.
+class PerfCounters
+{
+    public:
+        enum class Counter : uint8_t
+        {
+            Cycles,
+            Instructions,
+            BranchMisses,
+            L1Misses,
+            LLCMisses,
+            Count
+        };
+
+        static constexpr std::size_t CounterCount = static_cast<std::size_t>(Counter::Count);
+
+        struct Reading
+        {
+            // Scaled up when the kernel had to share the hardware between counters
+            std::array<std::optional<double>, CounterCount> values{};
+
+            auto get(const Counter counter) const -> std::optional<double>
+            {
+                return values[static_cast<std::size_t>(counter)];
+            }
+        };
+
+        PerfCounters();
+        ~PerfCounters();
+
+        PerfCounters(const PerfCounters&) = delete;
+        auto operator=(const PerfCounters&) -> PerfCounters& = delete;
+
+        // False if not a single counter could be opened, error() tells why
+        auto available() const -> bool;
+        auto error() const -> const std::string&;
+
+        auto start() -> void;
+        auto stop() -> Reading;
+
+        static auto name(const Counter counter) -> const char*;
+    private:
+        std::array<int, CounterCount> m_Fds;
+        std::string m_Error;
+}; // class PerfCounters
+
+// One line with IPC and the misses per node, or why there are no counters
+auto print_counters(std::ostream& out, const PerfCounters& counters, const PerfCounters::Reading& reading, const uint64_t nodes) -> void;
+
+} // namespace Profiling
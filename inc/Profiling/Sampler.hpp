@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Profiling
+{
+
+// Relative to the working directory, where the tools write the profile with --sample
+constexpr const char* DefaultProfilePath = "profile.folded";
+
+// Samples the call stacks of every thread of the process on a SIGPROF timer, which ticks with
+// the CPU time the process uses. Stacks are captured in the signal handler into a buffer
+// allocated up front, nothing is symbolized until writeFolded(). Linux only, one at a time.
+class Sampler
+{
+    public:
+        // Samples per second of CPU time, off the 100 Hz of other timers so it doesn't run in step
+        static constexpr int DefaultFrequency = 99;
+        // About 34 MB of frames, 11 minutes of one busy thread at the default frequency
+        static constexpr std::size_t DefaultCapacity = 1 << 16;
+        static constexpr std::size_t MaxDepth = 64;
+
+        // Starts sampling right away, unless available() says otherwise
+        explicit Sampler(const int frequency = DefaultFrequency, const std::size_t capacity = DefaultCapacity);
+        ~Sampler();
+
+        Sampler(const Sampler&) = delete;
+        auto operator=(const Sampler&) -> Sampler& = delete;
+
+        auto available() const -> bool;
+        auto error() const -> const std::string&;
+
+        // Idempotent, waits for handlers still running on other threads
+        auto stop() -> void;
+
+        auto samples() const -> std::size_t;
+        // Taken after the buffer was full
+        auto dropped() const -> std::size_t;
+
+        // Stops, then writes one line per distinct stack, "outer;inner;leaf count", the input of
+        // flamegraph.pl and speedscope. Frames are named with addr2line when it's installed,
+        // with the dynamic symbols otherwise. Returns false if the file can't be written.
+        auto writeFolded(const std::string& path) -> bool;
+    private:
+        std::size_t m_Capacity;
+        std::unique_ptr<void*[]> m_Frames;
+        std::unique_ptr<uint8_t[]> m_Depths;
+
+        // Claimed by the signal handler, may run past the capacity
+        std::atomic<std::size_t> m_Next{0};
+
+        bool m_Running{false};
+        std::string m_Error;
+
+        [[gnu::noinline]] static auto handle_signal(int signal) -> void;
+
+        [[gnu::noinline]] auto record() -> void;
+}; // class Sampler
+
+// Writes the profile and reports on stderr how many samples it has, or why there are none
+auto write_profile(Sampler& sampler, const std::string& path = DefaultProfilePath) -> void;
+
+} // namespace Profiling
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace Profiling
+{
+
+enum class Stat : uint8_t
+{
+    // Search, counted once per search() call, so the search loop itself never touches them
+    SearchNodes,        // all nodes, quiescence included
+    QuiescenceNodes,
+    SearchTime,         // nanoseconds
+    TableProbes,
+    TableHits,
+    BetaCutoffs,
+    FirstMoveCutoffs,   // cutoffs by the first move searched, a measure of the move ordering
+
+    // Board
+    MovesGenerated,     // pseudo-legal moves of the pieces whose legal moves were computed
+    LegalityChecks,
+
+    // Rendering
+    Frames,
+    FrameTime,          // nanoseconds spent in Renderer::render
+    DrawCalls,
+    StateChanges,       // binds of shaders, vertex arrays, buffers and textures
+
+    Count
+};
+
+constexpr std::size_t StatCount = static_cast<std::size_t>(Stat::Count);
+
+// Totals of all threads at one moment, subtract two to get what happened in between
+struct StatsSnapshot
+{
+    std::array<uint64_t, StatCount> values{};
+
+    auto get(const Stat stat) const -> uint64_t
+    {
+        return values[static_cast<std::size_t>(stat)];
+    }
+
+    auto operator-(const StatsSnapshot& earlier) const -> StatsSnapshot
+    {
+        StatsSnapshot difference;
+
+        for (std::size_t i = 0; i < StatCount; i++)
+            difference.values[i] = values[i] - earlier.values[i];
+
+        return difference;
+    }
+};
+
+// The counters of one thread, registered while the thread lives and summed by read_stats()
+struct ThreadStats
+{
+    std::array<std::atomic<uint64_t>, StatCount> values{};
+};
+
+auto local_stats() -> ThreadStats&;
+
+inline auto count(const Stat stat, const uint64_t amount = 1) -> void
+{
+    std::atomic<uint64_t>& value = local_stats().values[static_cast<std::size_t>(stat)];
+
+    // Only the owning thread writes, a plain add without a locked instruction. The atomic only
+    // keeps readers on other threads from seeing torn values.
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+// Sums the counters of the running threads and of the ones that already exited
+auto read_stats() -> StatsSnapshot;
+
+// A line per group that has any counts: search with NPS, table hit and first move cutoff
+// rates, board move generation, and rendering per frame
+auto print_stats(std::ostream& out, const StatsSnapshot& stats) -> void;
+
+} // namespace Profiling
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "Profiling/Macros.hpp"
+
+namespace Profiling
+{
+
+// Set by configuring with -DENABLE_TRACING=ON, the zones below compile to nothing otherwise
+#ifdef CHESS_TRACING
+constexpr bool TracingEnabled = true;
+#else
+constexpr bool TracingEnabled = false;
+#endif
+
+// Relative to the working directory, the window writes here on P and at exit
+constexpr const char* DefaultTracePath = "trace.json";
+
+// A finished zone, times are nanoseconds since the first zone of the process
+struct TraceEvent
+{
+    const char* name;
+    uint64_t start;
+    uint64_t duration;
+    uint32_t thread;
+};
+
+// Records the time between construction and destruction into the ring buffer of the calling
+// thread. The name has to outlive the trace, string literals only.
+class TraceZone
+{
+    public:
+        explicit TraceZone(const char* name) noexcept;
+        ~TraceZone();
+
+        TraceZone(const TraceZone&) = delete;
+        auto operator=(const TraceZone&) -> TraceZone& = delete;
+    private:
+        const char* m_Name;
+        uint64_t m_Start;
+}; // class TraceZone
+
+// Shown instead of the thread number in the trace viewer
+auto set_thread_name(const char* name) -> void;
+
+// Writes the events still in the ring buffers of all threads as Chrome trace JSON, which
+// chrome://tracing and ui.perfetto.dev open. Safe while other threads keep recording, returns
+// false if the file can't be written.
+auto dump_trace(const std::string& path) -> bool;
+
+} // namespace Profiling
+
+#ifdef CHESS_TRACING
+#define PROFILE_ZONE(name) const ::Profiling::TraceZone PROFILE_CONCAT(profile_zone_, __LINE__){name}
+#define PROFILE_THREAD(name) ::Profiling::set_thread_name(name)
+#else
+#define PROFILE_ZONE(name) static_cast<void>(0)
+#define PROFILE_THREAD(name) static_cast<void>(0)
+#endif
@@ -27,6 +27,8 @@ class Camera
         
         auto move(const vector movement) noexcept -> void;
         auto changeFov(const angle delta) noexcept -> void;
+        // Width over height of the window, the camera doesn't touch GLFW so it can live on any thread
+        auto setAspect(const float aspect) noexcept -> void;
 
         auto yaw(const angle delta) noexcept -> void;
         auto pitch(const angle delta) noexcept -> void;
@@ -52,6 +54,7 @@ class Camera
         matrix m_projection{};
 
         angle m_fov = 75.f;
+        float m_aspect = 4.f / 3.f;
 
         auto updateView() noexcept -> void;
         auto updateProjection() noexcept -> void;
@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include <string_view>
+#include <vector>
 
 #include <glad/gl.h>
 
@@ -14,6 +15,8 @@
 #include "Renderer/GPU/IndexBuffer.hpp"
 #include "Renderer/GPU/VertexBuffer.hpp"
 #include "Renderer/GPU/VertexBufferLayout.hpp"
+#include "Profiling/Stats.hpp"
+#include "Profiling/Trace.hpp"
 
 namespace Renderer
 {
@@ -22,9 +25,25 @@ namespace Renderer
 class Mesh
 {
     public:
-        // Constructor that loads a mesh from a file, it expects model that contains only one mesh
-        Mesh(std::string_view model_path)
+        struct Vertex
+        {
+            glm::vec3 position;
+            glm::vec3 normal;
+        };
+
+        // The model as read from the file, not yet on the GPU
+        struct Data
+        {
+            std::vector<Vertex> vertices;
+            std::vector<uint> indices;
+        };
+
+        // Parses a model that contains only one mesh, touches no GL state so any thread may call
+        // it. The data is empty if the model couldn't be loaded.
+        static auto load(std::string_view model_path) -> Data
         {
+            PROFILE_ZONE("Mesh::load");
+
             Assimp::Importer importer;
 
             const aiScene* scene = importer.ReadFile(
@@ -34,18 +53,34 @@ class Mesh
             if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
             {
                 std::cerr << "Assimp error: Couldn't load scene from file.\n";
-                return;
+                return {};
             }
 
-            setup_mesh(scene);
+            return read_mesh(scene);
+        }
+
+        // Uploads loaded data, only on the thread with the GL context
+        explicit Mesh(const Data& data)
+        {
+            if (!data.vertices.empty())
+                setup_mesh(data);
+        }
+
+        // Constructor that loads a mesh from a file, it expects model that contains only one mesh
+        Mesh(std::string_view model_path) :
+            Mesh{load(model_path)}
+        {
         }
 
         auto draw() const -> void
         {
+            PROFILE_ZONE("Mesh::draw");
+
             m_VAO->Bind();
             m_IBO->Bind();
 
             glDrawElements(GL_TRIANGLES, m_IBO->GetCount(), GL_UNSIGNED_INT, nullptr);
+            Profiling::count(Profiling::Stat::DrawCalls);
 
             m_IBO->Unbind();
             m_VAO->Unbind();
@@ -56,25 +91,19 @@ class Mesh
         std::unique_ptr<GPU::IndexBuffer>  m_IBO;
         std::unique_ptr<GPU::VertexBuffer> m_VBO;
 
-        // Fetches the mesh data from the scene and sets up the buffers
-        auto setup_mesh(const aiScene* scene) -> void
+        // Fetches the mesh data from the scene
+        static auto read_mesh(const aiScene* scene) -> Data
         {
             if (scene->mNumMeshes != 1)
             {
                 std::cerr << "Assimp error: Expected one mesh in the model.\n";
-                return;
+                return {};
             }
 
             const aiMesh* mesh = scene->mMeshes[0];
 
-            struct Vertex
-            {
-                glm::vec3 position;
-                glm::vec3 normal;
-            };
-
-            std::vector<Vertex> vertices;
-            vertices.reserve(mesh->mNumVertices);
+            Data data;
+            data.vertices.reserve(mesh->mNumVertices);
 
             for (size_t i = 0; i < mesh->mNumVertices; i++)
             {
@@ -95,23 +124,28 @@ class Mesh
                     normal.z
                 };
 
-                vertices.push_back(vertex);
+                data.vertices.push_back(vertex);
             }
 
-            std::vector<uint> indices;
-            indices.reserve(mesh->mNumFaces * 3);
+            data.indices.reserve(mesh->mNumFaces * 3);
 
             for (size_t i = 0; i < mesh->mNumFaces; i++)
             {
                 auto& face = mesh->mFaces[i];
 
                 for (size_t j = 0; j < face.mNumIndices; j++)
-                    indices.push_back(face.mIndices[j]);
+                    data.indices.push_back(face.mIndices[j]);
             }
 
+            return data;
+        }
+
+        // Sets up the buffers
+        auto setup_mesh(const Data& data) -> void
+        {
             m_VBO = std::make_unique<GPU::VertexBuffer>(
-                vertices.data(), 
-                vertices.size() * sizeof(Vertex));
+                data.vertices.data(), 
+                data.vertices.size() * sizeof(Vertex));
 
             GPU::VertexBufferLayout layout;
             layout.Push<float>(3);
@@ -121,8 +155,8 @@ class Mesh
             m_VAO->AddBuffer(*m_VBO, layout);
 
             m_IBO = std::make_unique<GPU::IndexBuffer>(
-                indices.data(), 
-                indices.size());
+                data.indices.data(), 
+                data.indices.size());
 
             m_VBO->Unbind();
             m_VAO->Unbind();
@@ -8,7 +8,7 @@
 #include <glm/glm.hpp>
 
 #include "Chess/Board.hpp"
-#include "Controller/Controller.hpp"
+#include "Controller/FrameState.hpp"
 #include "Renderer/Chessboard.hpp"
 
 namespace Renderer
@@ -17,13 +17,11 @@ namespace Renderer
 class Renderer
 {
     public:
-        Renderer(const Chess::Board& board, const Controller::Controller& controller);
+        Renderer(const Chess::Board& board);
 
-        auto render(const glm::mat4& projView, GLFWwindow* window) const -> void;
+        // Draws a frame published by the controller, never touches the board itself
+        auto render(const Controller::FrameState& frame, GLFWwindow* window) const -> void;
     private:
-        const Chess::Board& m_Board;
-        const Controller::Controller& m_Controller;
-
         // turn into a Mesh class
         const std::unique_ptr<Chessboard> m_BoardMesh;
 };
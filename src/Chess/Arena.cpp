@@ -0,0 +1,126 @@
+#include "Chess/Arena.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+
+#ifdef DEBUG
+constexpr std::size_t GuardSize = 16;
+constexpr std::byte GuardByte{0xCD};
+#endif
+
+} // namespace
+
+namespace Chess
+{
+
+Arena::Arena(const std::size_t capacity) :
+    m_Buffer{new std::byte[capacity]},
+    m_Capacity{capacity}
+{
+#ifdef DEBUG
+    m_Allocations.reserve(1024);
+#endif
+}
+
+Arena::~Arena()
+{
+    // Everything should have been released by its frame by now
+    if (m_Top != 0)
+        std::cerr << "Arena leaked " << m_Top << " bytes" << std::endl;
+}
+
+auto Arena::local() -> Arena&
+{
+    thread_local Arena arena{};
+
+    return arena;
+}
+
+auto Arena::allocate_bytes(const std::size_t size, const std::size_t alignment) -> void*
+{
+#ifdef DEBUG
+    // Nothing would ever release it
+    if (m_Depth == 0)
+    {
+        std::cerr << "Arena allocation of " << size << " bytes outside of a frame" << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+#endif
+
+    const std::size_t offset = (m_Top + alignment - 1) & ~(alignment - 1);
+    std::size_t end = offset + size;
+
+#ifdef DEBUG
+    end += GuardSize;
+#endif
+
+    if (end > m_Capacity)
+    {
+        std::cerr << "Arena overflow, " << end << " bytes needed out of " << m_Capacity << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+#ifdef DEBUG
+    std::fill(m_Buffer.get() + offset + size, m_Buffer.get() + end, GuardByte);
+    m_Allocations.push_back({offset, size});
+#endif
+
+    m_Top = end;
+
+    return m_Buffer.get() + offset;
+}
+
+auto Arena::release(const std::size_t mark, const std::size_t depth) -> void
+{
+    // Frames have to close in the reverse order they were opened
+    if (depth != m_Depth || mark > m_Top)
+    {
+        std::cerr << "Arena frame released out of order" << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+#ifdef DEBUG
+    check_guards(mark);
+#endif
+
+    m_Top = mark;
+    m_Depth--;
+}
+
+#ifdef DEBUG
+auto Arena::check_guards(const std::size_t mark) -> void
+{
+    while (!m_Allocations.empty() && m_Allocations.back().offset >= mark)
+    {
+        const Allocation& allocation = m_Allocations.back();
+        const std::byte* guard = m_Buffer.get() + allocation.offset + allocation.size;
+
+        if (std::any_of(guard, guard + GuardSize, [](const std::byte b) { return b != GuardByte; }))
+        {
+            std::cerr << "Arena allocation of " << allocation.size << " bytes at offset "
+                << allocation.offset << " was written past its end" << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+
+        m_Allocations.pop_back();
+    }
+}
+#endif
+
+Arena::Frame::Frame(Arena& arena) :
+    m_Arena{arena},
+    m_Mark{arena.m_Top},
+    m_Depth{++arena.m_Depth}
+{
+}
+
+Arena::Frame::~Frame()
+{
+    m_Arena.release(m_Mark, m_Depth);
+}
+
+} // namespace Chess
@@ -1,10 +1,17 @@
 #include "Chess/Board.hpp"
-
+#include "Chess/Position.hpp"
+#include "Jobs/Pool.hpp"
+#include "Profiling/Allocations.hpp"
+#include "Profiling/Stats.hpp"
+#include "Profiling/Trace.hpp"
+
+#include <algorithm>
+#include <atomic>
 #include <fstream>
-
-#include <glm/gtc/matrix_transform.hpp>
-
-#include "Renderer/Mesh.hpp"
+#include <iostream>
+#include <optional>
+#include <string>
+#include <utility>
 
 namespace
 {
@@ -47,6 +54,18 @@ auto parse_layout(const std::vector<std::string>& layout,
     }
 }
 
+// Move buffers are sized for the largest allowed board, a config that isn't within it never
+// gets as far as generating a move
+auto validate_size(const uint width, const uint height) -> void
+{
+    if (width == 0 || height == 0 || width > Chess::Board::MaxSide || height > Chess::Board::MaxSide)
+    {
+        std::cerr << "Unsupported board size " << width << "x" << height
+            << ", both sides must be between 1 and " << Chess::Board::MaxSide << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+}
+
 auto parse_config(
     const std::string_view config_file,
     uint& width,
@@ -64,6 +83,10 @@ auto parse_config(
 
     std::string line;
 
+    // A layout before any size line is rejected
+    width = 0;
+    height = 0;
+
     while (std::getline(file, line))
     {
         if (line.empty() || line[0] == '#')
@@ -91,6 +114,8 @@ auto parse_config(
         {
             width = std::stol(std::string{words[1]});
             height = std::stol(std::string{words[2]});
+
+            validate_size(width, height);
         }
         else if (words[0] == "player")
         {
@@ -98,6 +123,8 @@ auto parse_config(
         }
         else if (words[0] == "layout")
         {
+            validate_size(width, height);
+
             std::vector<std::string> layout{};
 
             for (size_t i = 0; i < height; i++)
@@ -123,33 +150,27 @@ auto parse_config(
     }
 
     file.close();
+
+    validate_size(width, height);
 }
 
-auto find_king(const Chess::Board::PieceMap& pieces, const Chess::Player color) -> Chess::Pos
+auto find_king(const Chess::PieceLists& lists, const Chess::Player color) -> Chess::Pos
 {
-    Chess::Pos king_pos{-1, -1};
+    const auto kings = lists.get(color, Chess::Piece::Type::King);
 
-    for (const auto& [pos, piece] : pieces)
+    if (kings.size() > 1)
     {
-        if (piece.type == Chess::Piece::Type::King && piece.color == color)
-        {
-            if (king_pos == Chess::Pos{-1, -1})
-                king_pos = pos;
-            else
-            {
-                std::cerr << "Multiple kings found for color " << static_cast<int>(color) << std::endl;
-                std::exit(EXIT_FAILURE);
-            }
-        }
+        std::cerr << "Multiple kings found for color " << static_cast<int>(color) << std::endl;
+        std::exit(EXIT_FAILURE);
     }
 
-    if (king_pos == Chess::Pos{-1, -1})
+    if (kings.empty())
     {
         std::cerr << "No king found for color " << static_cast<int>(color) << std::endl;
         std::exit(EXIT_FAILURE);
     }
 
-    return king_pos;
+    return kings[0];
 }
 
 auto find_piece(const Chess::Board::PieceMap& pieces, const Chess::Pos pos) -> std::optional<Chess::Piece>
@@ -162,12 +183,120 @@ auto find_piece(const Chess::Board::PieceMap& pieces, const Chess::Pos pos) -> s
     return it->second;
 }
 
+auto pick_layout(const Chess::Pos size) -> Chess::Board::Layout
+{
+    using Layout = Chess::Board::Layout;
+
+    if (size == Chess::Pos{8, 8})
+        return Layout::Standard;
+
+    if (size == Chess::Pos{16, 16})
+        return Layout::Big;
+
+    if (Chess::PositionN::fits(size))
+        return Layout::Dynamic;
+
+    return Layout::Unsupported;
+}
+
 template <typename T>
-auto append_data(std::vector<std::byte>& data, const T& value) -> void
+auto append_data(Chess::Move::SpecialMoveInfo& data, const T& value) -> void
 {
     const std::byte* bytes = reinterpret_cast<const std::byte*>(&value);
 
-    data.insert(data.end(), bytes, bytes + sizeof(T));
+    for (std::size_t i = 0; i < sizeof(T); i++)
+        data.push_back(bytes[i]);
+}
+
+// The board as it would be after a move, read through the unchanged piece map. Only the few
+// squares the move touches are overridden, so nothing shared is written.
+class MoveOverlay
+{
+    public:
+        MoveOverlay(const Chess::Board::PieceMap& pieces) : m_Pieces(pieces) {}
+
+        auto set(const Chess::Pos pos, const std::optional<Chess::Piece> piece) -> void
+        {
+            m_Overrides.push_back({pos, piece});
+        }
+
+        auto at(const Chess::Pos pos) const -> std::optional<Chess::Piece>
+        {
+            // Later overrides win, the rook of a castling can land where the king stood
+            for (std::size_t i = m_Overrides.size(); i-- > 0;)
+                if (m_Overrides[i].first == pos)
+                    return m_Overrides[i].second;
+
+            return find_piece(m_Pieces, pos);
+        }
+    private:
+        const Chess::Board::PieceMap& m_Pieces;
+        Chess::FixedVector<std::pair<Chess::Pos, std::optional<Chess::Piece>>, 5> m_Overrides;
+}; // class MoveOverlay
+
+// Looks outwards from the target for pieces of the given color that attack it, the same
+// squares their pseudo-legal moves would reach
+auto is_attacked(
+    const MoveOverlay& board,
+    const Chess::MoveTables& tables,
+    const Chess::Pos size,
+    const Chess::Pos target,
+    const Chess::Player by) -> bool
+{
+    using Type = Chess::Piece::Type;
+
+    auto is_piece = [&](const Chess::Pos pos, const Type type) -> bool
+    {
+        const auto piece = board.at(pos);
+
+        return piece != std::nullopt && piece->color == by && piece->type == type;
+    };
+
+    for (const Chess::Square square : tables.knight(target))
+        if (is_piece(tables.toPos(square), Type::Knight))
+            return true;
+
+    for (const Chess::Square square : tables.king(target))
+        if (is_piece(tables.toPos(square), Type::King))
+            return true;
+
+    // Pawns capture diagonally forward, so they sit one row behind the target
+    const int forward = by == Chess::Player::White ? 1 : -1;
+
+    for (int x = -1; x <= 1; x += 2)
+    {
+        const Chess::Pos pos = target - Chess::Pos{x, forward};
+
+        if (Chess::in_bounds(pos, size) && is_piece(pos, Type::Pawn))
+            return true;
+    }
+
+    for (const auto& [directions, slider] : {
+        std::pair{Chess::MoveTables::Diagonal, Type::Bishop},
+        std::pair{Chess::MoveTables::Straight, Type::Rook}})
+    for (const auto dir : directions)
+        for (const Chess::Square square : tables.ray(target, dir))
+        {
+            const auto piece = board.at(tables.toPos(square));
+
+            if (piece == std::nullopt)
+                continue;
+
+            if (piece->color == by && (piece->type == slider || piece->type == Type::Queen))
+                return true;
+
+            break;
+        }
+
+    return false;
+}
+
+// Same piece, squares and promotion, the check flags are only added once a move is played
+auto same_move(const Chess::Move& a, const Chess::Move& b) -> bool
+{
+    return a.from == b.from && a.to == b.to && std::equal(
+        a.specialMoveInfo.begin(), a.specialMoveInfo.end(),
+        b.specialMoveInfo.begin(), b.specialMoveInfo.end());
 }
 
 } // namespace
@@ -179,12 +308,29 @@ namespace Chess
 
 Board::Board(const std::string_view config_file)
 {
+    PROFILE_ALLOCATIONS("Board::Board");
+
     parse_config(config_file, m_Width, m_Height, m_StartingPlayer, m_Pieces);
 
-    m_KingWhite = find_king(m_Pieces, Player::White);
-    m_KingBlack = find_king(m_Pieces, Player::Black);
+    m_Tables = MoveTables{getSize()};
+    m_Layout = pick_layout(getSize());
+
+    // Every target a piece can have is on one of its square's lists, so this is never outgrown
+    // and views into it stay valid while more squares are computed
+    m_LegalTargets.reserve(m_Tables.targetCount());
+    m_LegalSlices.resize(m_Tables.squareCount());
+
+    m_PieceLists = PieceLists{getSize()};
 
+    for (const auto& [pos, piece] : m_Pieces)
+        m_PieceLists.add(pos, piece);
+
+    m_KingWhite = find_king(m_PieceLists, Player::White);
+    m_KingBlack = find_king(m_PieceLists, Player::Black);
+
+    save_checkpoint();
     update();
+    publish_snapshot();
 }
 
 auto Board::getSize() const -> Pos
@@ -197,6 +343,11 @@ auto Board::getPieces() const -> const PieceMap&
     return m_Pieces;
 }
 
+auto Board::getPieceLists() const -> const PieceLists&
+{
+    return m_PieceLists;
+}
+
 auto Board::getKingPos(const Player color) const -> Pos
 {
     return color == Player::White ? m_KingWhite : m_KingBlack;
@@ -210,35 +361,108 @@ auto Board::getCurrentTurn() const -> Player
     return !m_MoveHistory.back().player;
 }
 
-auto Board::getPossibleMoves(const Pos from) const -> std::vector<Move>
+auto Board::getPossibleMoves(const Pos from) -> std::vector<Move>
+{
+    MoveBuffer moves;
+    getPossibleMoves(from, moves);
+
+    return {moves.begin(), moves.end()};
+}
+
+auto Board::getPossibleMoves(const Pos from, MoveBuffer& moves) -> void
 {
+    PROFILE_ALLOCATIONS("Board::getPossibleMoves");
+
     auto piece = find_piece(m_Pieces, from);
 
     if (piece == std::nullopt)
-        return {};
+        return;
 
     if (piece->color != getCurrentTurn())
-        return {};
+        return;
 
-    std::vector<Move> moves;
-
-    for (const auto& to : m_PossibleMoves.at(from))
+    for (const auto& to : getLegalMoves(from))
         moves.push_back(
             create_move(from, to)
         );
+}
 
-    return moves;
+auto Board::getLegalMoves(const Pos from) -> std::span<const Pos>
+{
+    if (!in_bounds(from, getSize()))
+        return {};
+
+    const LegalSlice& slice = legal_slice(m_Tables.toSquare(from));
+
+    return {m_LegalTargets.data() + slice.begin, m_LegalTargets.data() + slice.end};
 }
 
+auto Board::getLegalMoves() -> std::span<const Pos>
+{
+    PROFILE_ZONE("Board::getLegalMoves");
+    PROFILE_ALLOCATIONS("Board::getLegalMoves");
+
+    if (use_parallel_filtering())
+        compute_legal_moves_parallel();
 
-auto Board::getPiecesAttackingPos(const Pos pos, const Player color, std::vector<Pos>& attackers) const -> void
+    for (std::size_t square = 0; square < m_LegalSlices.size(); square++)
+        legal_slice(square);
+
+    return m_LegalTargets;
+}
+
+auto Board::getPseudoLegalMoves(const Pos from, TargetBuffer& moves) const -> void
 {
-    for (const auto& [piece_pos, piece] : m_Pieces)
+    get_moves(from, moves);
+}
+
+auto Board::hasAnyLegalMove() -> bool
+{
+    if (use_parallel_filtering())
+        return has_any_legal_move_parallel();
+
+    const Player current = getCurrentTurn();
+
+    // Only the pieces of the side to move are visited. The board isn't played on, so the lists
+    // stay as they are while they're walked.
+    for (int type = 0; type < PieceLists::KindCount / 2; type++)
+    for (const Pos pos : m_PieceLists.get(current, static_cast<Piece::Type>(type)))
     {
-        if (piece.color != color)
+        const LegalSlice& slice = m_LegalSlices[m_Tables.toSquare(pos)];
+
+        if (slice.epoch == m_LegalEpoch)
+        {
+            if (slice.begin != slice.end)
+                return true;
+
             continue;
+        }
+
+        TargetBuffer moves;
+        get_moves(pos, moves);
 
-        const auto moves = get_moves(piece_pos);
+        Profiling::count(Profiling::Stat::MovesGenerated, moves.size());
+
+        for (const Pos to : moves)
+            if (is_legal_readonly(pos, to))
+                return true;
+    }
+
+    return false;
+}
+
+auto Board::setFiltering(const Filtering filtering) -> void
+{
+    m_Filtering = filtering;
+}
+
+auto Board::getPiecesAttackingPos(const Pos pos, const Player color, std::vector<Pos>& attackers) const -> void
+{
+    for (int type = 0; type < PieceLists::KindCount / 2; type++)
+    for (const Pos piece_pos : m_PieceLists.get(color, static_cast<Piece::Type>(type)))
+    {
+        TargetBuffer moves;
+        get_moves(piece_pos, moves);
 
         if (std::find(moves.begin(), moves.end(), pos) != moves.end())
             attackers.push_back(piece_pos);
@@ -247,12 +471,11 @@ auto Board::getPiecesAttackingPos(const Pos pos, const Player color, std::vector
 
 auto Board::checkIfAttackingPos(const Pos pos, const Player color) const -> bool
 {
-    for (const auto& [piece_pos, piece] : m_Pieces)
+    for (int type = 0; type < PieceLists::KindCount / 2; type++)
+    for (const Pos piece_pos : m_PieceLists.get(color, static_cast<Piece::Type>(type)))
     {
-        if (piece.color != color)
-            continue;
-
-        const auto moves = get_moves(piece_pos);
+        TargetBuffer moves;
+        get_moves(piece_pos, moves);
 
         if (std::find(moves.begin(), moves.end(), pos) != moves.end())
             return true;
@@ -263,19 +486,100 @@ auto Board::checkIfAttackingPos(const Pos pos, const Player color) const -> bool
 
 auto Board::executeMove(const Move& move) -> void
 {
+    PROFILE_ZONE("Board::executeMove");
+    PROFILE_ALLOCATIONS("Board::executeMove");
+
+    save_ply();
+
+    // Playing the move that was undone last keeps the positions after it
+    if (!m_RedoMoves.empty() && same_move(m_RedoMoves.back(), move))
+    {
+        m_RedoMoves.pop_back();
+    }
+    else
+    {
+        m_RedoMoves.clear();
+        drop_plies_after(m_MoveHistory.size());
+
+        m_Checkpoints.resize(m_MoveHistory.size() / CheckpointInterval + 1);
+    }
 
     execute(move);
-    update();
+
+    const std::size_t ply = m_MoveHistory.size();
+
+    if (ply % CheckpointInterval == 0 && ply / CheckpointInterval == m_Checkpoints.size())
+        save_checkpoint();
+
+    if (!restore_ply())
+        update();
+
+    publish_snapshot();
 }
 
 auto Board::undoMove() -> Move
 {
+    if (m_MoveHistory.empty())
+        return undo();
+
+    save_ply();
+
     auto move = undo();
-    update();
+    m_RedoMoves.push_back(move);
+
+    if (!restore_ply())
+        update();
+
+    publish_snapshot();
 
     return move;
 }
 
+auto Board::redoMove() -> bool
+{
+    if (m_RedoMoves.empty())
+        return false;
+
+    executeMove(m_RedoMoves.back());
+
+    return true;
+}
+
+auto Board::jumpToPly(const std::size_t ply) -> bool
+{
+    if (ply > m_MoveHistory.size() + m_RedoMoves.size())
+        return false;
+
+    if (ply == m_MoveHistory.size())
+        return true;
+
+    save_ply();
+
+    // Lay out the whole game in the history, then everything past the ply becomes undone moves
+    m_MoveHistory.insert(m_MoveHistory.end(), m_RedoMoves.rbegin(), m_RedoMoves.rend());
+    m_RedoMoves.assign(m_MoveHistory.rbegin(), m_MoveHistory.rend() - ply);
+
+    // Only the pieces go back to the checkpoint, the moves after it are replayed onto them
+    const std::size_t base = restore_checkpoint(ply);
+
+    FixedVector<Move, CheckpointInterval> replay;
+
+    for (std::size_t i = base; i < ply; i++)
+        replay.push_back(m_MoveHistory[i]);
+
+    m_MoveHistory.resize(base);
+
+    for (const Move& move : replay)
+        execute(move);
+
+    if (!restore_ply())
+        update();
+
+    publish_snapshot();
+
+    return true;
+}
+
 auto Board::getCurrentGameState() const -> Controller::GameState
 {
     if (m_MoveHistory.empty())
@@ -293,11 +597,43 @@ auto Board::getCurrentGameState() const -> Controller::GameState
     return Controller::GameState::Playing;
 }
 
+auto Board::getMoveHistory() const -> const MoveList&
+{
+    return m_MoveHistory;
+}
+
+auto Board::getMoveTables() const -> const MoveTables&
+{
+    return m_Tables;
+}
+
+auto Board::getLayout() const -> Layout
+{
+    return m_Layout;
+}
+
+auto Board::getSnapshots() const -> SnapshotChannel&
+{
+    return *m_Snapshots;
+}
+
 auto Board::reset() -> void
 {
-    while(!m_MoveHistory.empty())
-        undo();
+    restore_checkpoint(0);
+
+    m_MoveHistory.clear();
+    m_RedoMoves.clear();
+    m_Checkpoints.resize(1);
+    drop_plies_after(0);
+
+    if (!restore_ply())
+        update();
 
+    publish_snapshot();
+}
+
+auto Board::refresh() -> void
+{
     update();
 }
 
@@ -305,48 +641,85 @@ auto Board::reset() -> void
 
 auto Board::update() -> void
 {
-    if (m_MoveHistory.empty())
-        return calculate_possible_moves_initial();
+    PROFILE_ZONE("Board::update");
+    PROFILE_ALLOCATIONS("Board::update");
+
+    invalidate_legal_moves();
 
-    calculate_possible_moves(m_MoveHistory.back());
+    if (m_MoveHistory.empty())
+        return;
 
-    auto& last_move = m_MoveHistory.back();
+    const Move& last_move = m_MoveHistory.back();
 
-    const std::vector<Pos>& moves = m_PossibleMoves.at(last_move.to);
+    TargetBuffer moves;
+    get_moves(last_move.to, moves);
 
     // Add info about check to the move
-    if (std::find(moves.begin(), moves.end(),
-        getKingPos(!last_move.player)) != moves.end())
-    {
-        last_move.type |= static_cast<uint>(Move::Type::Check);
-    }
+    const bool check = std::find(moves.begin(), moves.end(),
+        getKingPos(!last_move.player)) != moves.end();
+
+    if (check)
+        m_MoveHistory.back().type |= static_cast<uint>(Move::Type::Check);
 
     // Add info about checkmate/stalemate to the move
-    Player current = getCurrentTurn();
-    bool no_moves = true;
+    if (!hasAnyLegalMove())
+        m_MoveHistory.back().type |= static_cast<uint>(check ? Move::Type::Checkmate : Move::Type::Stalemate);
+}
 
-    for (const auto& [pos, moves] : m_PossibleMoves)
-        if (m_Pieces.at(pos).color == current && !moves.empty())
-        {
-            no_moves = false;
-            break;
-        }
+auto Board::publish_snapshot() -> void
+{
+    auto snapshot = std::make_unique<Snapshot>();
+
+    snapshot->version = ++m_SnapshotVersion;
+    snapshot->size = getSize();
+    snapshot->turn = getCurrentTurn();
+    snapshot->state = getCurrentGameState();
+    snapshot->ply = m_MoveHistory.size();
+    snapshot->kings = {m_KingWhite, m_KingBlack};
 
-    if (no_moves)
+    if (!m_MoveHistory.empty())
+        snapshot->lastMove = m_MoveHistory.back();
+
+    snapshot->pieces.reserve(m_Pieces.size());
+
+    for (int kind = 0; kind < PieceLists::KindCount; kind++)
     {
-        if (last_move.isType(Move::Type::Check))
-            last_move.type |= static_cast<uint>(Move::Type::Checkmate);
-        else
-            last_move.type |= static_cast<uint>(Move::Type::Stalemate);
+        const Player color = static_cast<Player>(kind / (PieceLists::KindCount / 2));
+        const auto type = static_cast<Piece::Type>(kind % (PieceLists::KindCount / 2));
+
+        snapshot->kindBegin[kind] = snapshot->pieces.size();
+
+        for (const Pos pos : m_PieceLists.get(color, type))
+            snapshot->pieces.push_back({pos, m_Pieces.at(pos)});
     }
+
+    snapshot->kindBegin[PieceLists::KindCount] = snapshot->pieces.size();
+
+    m_Snapshots->publish(std::move(snapshot));
 }
 
 auto Board::execute(const Move& move) -> void
 {
     m_MoveHistory.push_back(move);
 
+    auto it = move.specialMoveInfo.data();
+
+    // The captured piece leaves first, it may stand on the target square
+    if (move.isType(Move::Type::Capture))
+    {
+        const Pos cap_pos = *reinterpret_cast<const Pos*>(it);
+        it += sizeof(cap_pos);
+
+        const Piece cap_piece = *reinterpret_cast<const Piece*>(it);
+        it += sizeof(cap_piece);
+
+        m_Pieces.erase(cap_pos);
+        m_PieceLists.remove(cap_pos, cap_piece);
+    }
+
     m_Pieces[move.to] = m_Pieces[move.from];
     m_Pieces[move.to].moved = true;
+    m_PieceLists.move(move.from, move.to, m_Pieces[move.to]);
 
     if (m_Pieces[move.to].type == Piece::Type::King)
     {
@@ -358,26 +731,14 @@ auto Board::execute(const Move& move) -> void
 
     m_Pieces.erase(move.from);
 
-    auto it = move.specialMoveInfo.data();
-
-    if (move.isType(Move::Type::Capture))
-    {
-        const Pos cap_pos = *reinterpret_cast<const Pos*>(it);
-        it += sizeof(cap_pos);
-
-        const Piece cap_piece = *reinterpret_cast<const Piece*>(it);
-        it += sizeof(cap_piece);
-
-        if (cap_pos != move.to)
-            m_Pieces.erase(cap_pos);
-    }
-
     if (move.isType(Move::Type::Promotion))
     {
         const Piece::Type promoted = *reinterpret_cast<const Piece::Type*>(it);
         it += sizeof(promoted);
 
+        m_PieceLists.remove(move.to, m_Pieces[move.to]);
         m_Pieces[move.to].type = promoted;
+        m_PieceLists.add(move.to, m_Pieces[move.to]);
     }
 
     if (move.isType(Move::Type::Castling))
@@ -390,6 +751,7 @@ auto Board::execute(const Move& move) -> void
 
         m_Pieces[rook_to] = m_Pieces[rook_from];
         m_Pieces[rook_to].moved = true;
+        m_PieceLists.move(rook_from, rook_to, m_Pieces[rook_to]);
 
         m_Pieces.erase(rook_from);
     }
@@ -408,6 +770,7 @@ auto Board::undo() -> Move
 
     m_Pieces[move.from] = m_Pieces[move.to];
     m_Pieces.erase(move.to);
+    m_PieceLists.move(move.to, move.from, m_Pieces[move.from]);
 
     if (m_Pieces[move.from].type == Piece::Type::King)
     {
@@ -428,11 +791,14 @@ auto Board::undo() -> Move
         it += sizeof(cap_piece);
 
         m_Pieces[cap_pos] = cap_piece;
+        m_PieceLists.add(cap_pos, cap_piece);
     }
 
     if (move.isType(Move::Type::Promotion))
     {
+        m_PieceLists.remove(move.from, m_Pieces[move.from]);
         m_Pieces[move.from].type = Piece::Type::Pawn;
+        m_PieceLists.add(move.from, m_Pieces[move.from]);
     }
 
     if (move.isType(Move::Type::Castling))
@@ -445,6 +811,7 @@ auto Board::undo() -> Move
 
         m_Pieces[rook_from] = m_Pieces[rook_to];
         m_Pieces[rook_from].moved = false;
+        m_PieceLists.move(rook_to, rook_from, m_Pieces[rook_from]);
 
         // Check in case if kings initial position is 1 square away from rook
         if (rook_to != move.from)
@@ -539,43 +906,293 @@ auto Board::create_move(const Pos from, const Pos to, const std::optional<Piece:
     };
 }
 
-auto Board::calculate_possible_moves(const Move& /* move */) -> void
+auto Board::invalidate_legal_moves() -> void
 {
-    // TODO: Only update the moves that are affected by the last move
-    calculate_possible_moves_initial();
+    m_LegalTargets.clear();
+    m_LegalEpoch++;
 }
 
-auto Board::calculate_possible_moves_initial() -> void
+auto Board::save_ply() -> void
 {
-    m_PossibleMoves.clear();
+    PlyCache& entry = m_PlyCache[m_MoveHistory.size() % PlyCacheSize];
 
-    // Get all moves a piece can make
-    for (const auto& [pos, piece] : m_Pieces)
-        m_PossibleMoves[pos] = get_moves(pos);
+    entry.ply = m_MoveHistory.size();
+    entry.flags = m_MoveHistory.empty() ? 0 : m_MoveHistory.back().type;
+    entry.targets.assign(m_LegalTargets.begin(), m_LegalTargets.end());
+    entry.slices.resize(m_LegalSlices.size());
+
+    for (std::size_t square = 0; square < m_LegalSlices.size(); square++)
+    {
+        const LegalSlice& slice = m_LegalSlices[square];
+
+        entry.slices[square] = {slice.begin, slice.end, slice.epoch == m_LegalEpoch};
+    }
+}
+
+auto Board::restore_ply() -> bool
+{
+    const PlyCache& entry = m_PlyCache[m_MoveHistory.size() % PlyCacheSize];
+
+    if (entry.ply != m_MoveHistory.size())
+        return false;
+
+    invalidate_legal_moves();
+
+    m_LegalTargets.assign(entry.targets.begin(), entry.targets.end());
+
+    for (std::size_t square = 0; square < m_LegalSlices.size(); square++)
+        if (entry.slices[square].epoch)
+            m_LegalSlices[square] = {entry.slices[square].begin, entry.slices[square].end, m_LegalEpoch};
+
+    if (!m_MoveHistory.empty())
+        m_MoveHistory.back().type = entry.flags;
+
+    return true;
+}
+
+auto Board::drop_plies_after(const std::size_t ply) -> void
+{
+    for (PlyCache& entry : m_PlyCache)
+        if (entry.ply > ply)
+            entry.ply = std::nullopt;
+}
+
+auto Board::save_checkpoint() -> void
+{
+    m_Checkpoints.push_back(Checkpoint{
+        .pieces = {m_Pieces.begin(), m_Pieces.end()},
+        .kingWhite = m_KingWhite,
+        .kingBlack = m_KingBlack
+    });
+}
+
+auto Board::restore_checkpoint(const std::size_t ply) -> std::size_t
+{
+    const Checkpoint& checkpoint = m_Checkpoints[ply / CheckpointInterval];
+
+    m_Pieces.clear();
+    m_Pieces.insert(checkpoint.pieces.begin(), checkpoint.pieces.end());
+
+    m_PieceLists.clear();
+
+    for (const auto& [pos, piece] : checkpoint.pieces)
+        m_PieceLists.add(pos, piece);
+
+    m_KingWhite = checkpoint.kingWhite;
+    m_KingBlack = checkpoint.kingBlack;
+
+    return ply - ply % CheckpointInterval;
+}
 
-    // Filter out moves that would put the king in check
-    for (auto& [pos, moves] : m_PossibleMoves)
+auto Board::legal_slice(const Square square) -> const LegalSlice&
+{
+    LegalSlice& slice = m_LegalSlices[square];
+
+    if (slice.epoch == m_LegalEpoch)
+        return slice;
+
+    slice.begin = m_LegalTargets.size();
+
+    const Pos pos = m_Tables.toPos(square);
+    const auto piece = find_piece(m_Pieces, pos);
+
+    if (piece != std::nullopt && piece->color == getCurrentTurn())
+    {
+        // Get all moves a piece can make, and keep those that don't put the king in check
+        TargetBuffer moves;
+        get_moves(pos, moves);
+
+        Profiling::count(Profiling::Stat::MovesGenerated, moves.size());
+
+        for (const Pos to : moves)
+            if (is_legal_readonly(pos, to))
+                m_LegalTargets.push_back(to);
+    }
+
+    slice.end = m_LegalTargets.size();
+    slice.epoch = m_LegalEpoch;
+
+    return slice;
+}
+
+auto Board::is_legal_readonly(const Pos from, const Pos to) const -> bool
+{
+    Profiling::count(Profiling::Stat::LegalityChecks);
+
+    const Piece piece = m_Pieces.at(from);
+
+    MoveOverlay board{m_Pieces};
+
+    board.set(from, std::nullopt);
+    board.set(to, piece);
+
+    // En passant takes a pawn beside the target square
+    if (piece.type == Piece::Type::Pawn && to.x != from.x && find_piece(m_Pieces, to) == std::nullopt)
+        board.set(Pos{to.x, from.y}, std::nullopt);
+
+    // Castling moves the first piece past the target, the rook, next to the king
+    if (piece.type == Piece::Type::King && std::abs(from.x - to.x) == 2)
+    {
+        const int dir = to.x - from.x > 0 ? 1 : -1;
+
+        Pos rook_from = to;
+
+        while (find_piece(m_Pieces, rook_from) == std::nullopt)
+            rook_from += Pos{dir, 0};
+
+        const Piece rook = m_Pieces.at(rook_from);
+
+        board.set(rook_from, std::nullopt);
+        board.set(to - Pos{dir, 0}, rook);
+    }
+
+    const Pos king = piece.type == Piece::Type::King ? to : getKingPos(piece.color);
+
+    return !is_attacked(board, m_Tables, getSize(), king, !piece.color);
+}
+
+auto Board::use_parallel_filtering() const -> bool
+{
+    if (m_Filtering != Filtering::Auto)
+        return m_Filtering == Filtering::Parallel;
+
+    // Without a pool the parallel path would just run serially with more bookkeeping
+    if (!Jobs::Pool::current())
+        return false;
+
+    if (m_Tables.squareCount() < ParallelMinSquares)
+        return false;
+
+    return m_PieceLists.count(getCurrentTurn()) >= ParallelMinPieces;
+}
+
+auto Board::compute_legal_moves_parallel() -> void
+{
+    PROFILE_ZONE("Board::compute_legal_moves_parallel");
+
+    const Player current = getCurrentTurn();
+
+    // Squares in ascending order, so the merged targets come out exactly as the serial path
+    // would append them
+    std::vector<Square> pending;
+
+    for (std::size_t square = 0; square < m_LegalSlices.size(); square++)
     {
-        const Piece piece = m_Pieces.at(pos);
+        if (m_LegalSlices[square].epoch == m_LegalEpoch)
+            continue;
+
+        const auto piece = find_piece(m_Pieces, m_Tables.toPos(square));
+
+        if (piece != std::nullopt && piece->color == current)
+            pending.push_back(square);
+    }
+
+    if (pending.empty())
+        return;
+
+    // Every chunk only reads the board and writes its own targets, the pieces it filtered are
+    // recorded as (chunk, begin, end) so they can be merged in square order afterwards
+    struct Range
+    {
+        uint32_t chunk;
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    std::vector<std::vector<Pos>> chunk_targets(pending.size());
+    std::vector<Range> ranges(pending.size());
+
+    // Chunks are indexed by their first piece, which is unique
+    Jobs::parallel_for(pending.size(), ParallelGrain, [&](const std::size_t begin, const std::size_t end)
+    {
+        PROFILE_ZONE("Board::compute_legal_moves_parallel chunk");
 
-        auto it = moves.begin();
+        std::vector<Pos>& targets = chunk_targets[begin];
 
-        while (it != moves.end())
+        for (std::size_t i = begin; i < end; i++)
         {
-            const Move move = create_move(pos, *it);
+            const Pos pos = m_Tables.toPos(pending[i]);
+
+            TargetBuffer moves;
+            get_moves(pos, moves);
 
-            execute(move);
+            Profiling::count(Profiling::Stat::MovesGenerated, moves.size());
 
-            const Pos king_pos = getKingPos(piece.color);
+            ranges[i].chunk = begin;
+            ranges[i].begin = targets.size();
 
-            if (checkIfAttackingPos(king_pos, !piece.color))
-                it = moves.erase(it);
-            else
-                ++it;
+            for (const Pos to : moves)
+                if (is_legal_readonly(pos, to))
+                    targets.push_back(to);
 
-            undo();
+            ranges[i].end = targets.size();
         }
+    });
+
+    for (std::size_t i = 0; i < pending.size(); i++)
+    {
+        const Range& range = ranges[i];
+        const std::vector<Pos>& targets = chunk_targets[range.chunk];
+
+        LegalSlice& slice = m_LegalSlices[pending[i]];
+
+        slice.begin = m_LegalTargets.size();
+        m_LegalTargets.insert(m_LegalTargets.end(),
+            targets.begin() + range.begin, targets.begin() + range.end);
+        slice.end = m_LegalTargets.size();
+        slice.epoch = m_LegalEpoch;
+    }
+}
+
+auto Board::has_any_legal_move_parallel() const -> bool
+{
+    PROFILE_ZONE("Board::has_any_legal_move_parallel");
+
+    const Player current = getCurrentTurn();
+
+    std::vector<Pos> pieces;
+    pieces.reserve(m_PieceLists.count(current));
+
+    for (int type = 0; type < PieceLists::KindCount / 2; type++)
+    {
+        const auto list = m_PieceLists.get(current, static_cast<Piece::Type>(type));
+        pieces.insert(pieces.end(), list.begin(), list.end());
     }
+
+    // Set by the first chunk that finds a legal move, the others stop at their next piece
+    std::atomic<bool> found{false};
+
+    Jobs::parallel_for(pieces.size(), ParallelGrain, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t i = begin; i < end && !found.load(std::memory_order_relaxed); i++)
+        {
+            const LegalSlice& slice = m_LegalSlices[m_Tables.toSquare(pieces[i])];
+
+            if (slice.epoch == m_LegalEpoch)
+            {
+                if (slice.begin != slice.end)
+                    found.store(true, std::memory_order_relaxed);
+
+                continue;
+            }
+
+            TargetBuffer moves;
+            get_moves(pieces[i], moves);
+
+            Profiling::count(Profiling::Stat::MovesGenerated, moves.size());
+
+            for (const Pos to : moves)
+            {
+                if (is_legal_readonly(pieces[i], to))
+                {
+                    found.store(true, std::memory_order_relaxed);
+                    break;
+                }
+            }
+        }
+    });
+
+    return found.load();
 }
 
 } // namespace Chess
@@ -0,0 +1,102 @@
+#include "Chess/Cpu.hpp"
+
+#include <array>
+
+#include "Chess/Fill.hpp"
+#include "Chess/Magic.hpp"
+
+namespace
+{
+
+using Chess::IsaLevel;
+
+constexpr std::array<std::string_view, 4> LevelNames = {"scalar", "sse4.2", "avx2", "avx512"};
+
+// Every feature of a level, the target attributes of its variants enable exactly these
+auto cpu_supports(const IsaLevel level) -> bool
+{
+#if defined(__x86_64__)
+    switch (level)
+    {
+        case IsaLevel::Scalar:
+            return true;
+        case IsaLevel::Sse42:
+            return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt");
+        case IsaLevel::Avx2:
+            return cpu_supports(IsaLevel::Sse42) && __builtin_cpu_supports("avx2")
+                && __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2");
+        case IsaLevel::Avx512:
+            return cpu_supports(IsaLevel::Avx2) && __builtin_cpu_supports("avx512f")
+                && __builtin_cpu_supports("avx512vl");
+    }
+
+    return false;
+#else
+    return level == IsaLevel::Scalar;
+#endif
+}
+
+} // namespace
+
+namespace Chess
+{
+
+constinit Dispatch dispatch{
+    .level = IsaLevel::Scalar,
+    .sliderLookup = SliderLookup::Magic,
+    .fillKernel = FillKernel::None
+};
+
+auto detect_isa_level() -> IsaLevel
+{
+    for (const IsaLevel level : {IsaLevel::Avx512, IsaLevel::Avx2, IsaLevel::Sse42})
+        if (cpu_supports(level))
+            return level;
+
+    return IsaLevel::Scalar;
+}
+
+auto init_isa_level() -> void
+{
+    set_isa_level(detect_isa_level());
+}
+
+auto get_isa_level() -> IsaLevel
+{
+    return dispatch.level;
+}
+
+auto set_isa_level(const IsaLevel level) -> bool
+{
+    if (!cpu_supports(level))
+        return false;
+
+    // Supported by the level, so neither call can fail. Fills stay off unless they are in use,
+    // and never fall back to the scalar kernel, which loses to walking the rays.
+    set_slider_lookup(level >= IsaLevel::Avx2 ? SliderLookup::Pext : SliderLookup::Magic);
+
+    if (get_fill_kernel() != FillKernel::None)
+        set_fill_kernel(
+            level >= IsaLevel::Avx512 ? FillKernel::Avx512 :
+            level >= IsaLevel::Avx2 ? FillKernel::Avx2 : FillKernel::None);
+
+    dispatch.level = level;
+
+    return true;
+}
+
+auto isa_level_name(const IsaLevel level) -> std::string_view
+{
+    return LevelNames[static_cast<std::size_t>(level)];
+}
+
+auto parse_isa_level(const std::string_view name) -> std::optional<IsaLevel>
+{
+    for (std::size_t i = 0; i < LevelNames.size(); i++)
+        if (LevelNames[i] == name)
+            return static_cast<IsaLevel>(i);
+
+    return std::nullopt;
+}
+
+} // namespace Chess
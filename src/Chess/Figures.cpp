@@ -1,6 +1,7 @@
 #include "Chess/Board.hpp"
 
 #include <array>
+#include <cstdlib>
 #include <optional>
 
 #include "Chess/Common.hpp"
@@ -20,17 +21,16 @@ auto find_piece(const Chess::Board::PieceMap& pieces, const Chess::Pos pos) -> s
 
 auto append_moves_in_direction(
     const Chess::Board::PieceMap& pieces,
+    const Chess::MoveTables& tables,
     const Chess::Pos from,
-    const Chess::Pos dir,
-    const Chess::Pos size,
-    std::vector<Chess::Pos>& moves) -> void
+    const Chess::MoveTables::Direction dir,
+    Chess::Board::TargetBuffer& moves) -> void
 {
     const Chess::Player color = pieces.at(from).color;
 
-    Chess::Pos next = from + dir;
-
-    while (Chess::in_bounds(next, size))
+    for (const Chess::Square square : tables.ray(from, dir))
     {
+        const Chess::Pos next = tables.toPos(square);
         auto piece = find_piece(pieces, next);
 
         if (piece == std::nullopt)
@@ -44,8 +44,6 @@ auto append_moves_in_direction(
 
             break;
         }
-
-        next += dir;
     }
 }
 
@@ -54,31 +52,45 @@ auto append_moves_in_direction(
 namespace Chess
 {
 
-auto Board::get_moves(const Pos from) const -> std::vector<Pos>
+auto Board::get_moves(const Pos from, TargetBuffer& moves) const -> void
 {
     using Type = Piece::Type;
 
     const auto piece = m_Pieces.find(from);
 
     if (piece == m_Pieces.end())
-        return {};
+        return;
 
     const auto [pos, pic] = *piece;
 
-    return pic.type == Type::Pawn   ? get_moves_by_type<Type::Pawn>(from, pic.color)
-        : pic.type == Type::Knight  ? get_moves_by_type<Type::Knight>(from, pic.color)
-        : pic.type == Type::Bishop  ? get_moves_by_type<Type::Bishop>(from, pic.color)
-        : pic.type == Type::Rook    ? get_moves_by_type<Type::Rook>(from, pic.color)
-        : pic.type == Type::Queen   ? get_moves_by_type<Type::Queen>(from, pic.color)
-        : pic.type == Type::King    ? get_moves_by_type<Type::King>(from, pic.color)
-        : std::vector<Pos>{};
+    switch (pic.type)
+    {
+        case Type::Pawn:
+            return get_moves_by_type<Type::Pawn>(from, pic.color, moves);
+        case Type::Knight:
+            return get_moves_by_type<Type::Knight>(from, pic.color, moves);
+        case Type::Bishop:
+            return get_moves_by_type<Type::Bishop>(from, pic.color, moves);
+        case Type::Rook:
+            return get_moves_by_type<Type::Rook>(from, pic.color, moves);
+        case Type::Queen:
+            return get_moves_by_type<Type::Queen>(from, pic.color, moves);
+        case Type::King:
+            return get_moves_by_type<Type::King>(from, pic.color, moves);
+    }
 }
 
-template<>
-auto Board::get_moves_by_type<Piece::Type::Pawn>(const Pos from, const Player color) const -> std::vector<Pos>
+auto Board::get_moves(const Pos from) const -> std::vector<Pos>
 {
-    std::vector<Pos> moves;
+    TargetBuffer moves;
+    get_moves(from, moves);
+
+    return {moves.begin(), moves.end()};
+}
 
+template<>
+auto Board::get_moves_by_type<Piece::Type::Pawn>(const Pos from, const Player color, TargetBuffer& moves) const -> void
+{
     const int forward =
         color == Player::White ? 1 : -1;
 
@@ -124,121 +136,64 @@ auto Board::get_moves_by_type<Piece::Type::Pawn>(const Pos from, const Player co
             && last_move.to.y == from.y)
             moves.push_back(last_move.to + Pos{0, forward});
     }
-
-    return moves;
 }
 
 template<>
-auto Board::get_moves_by_type<Piece::Type::Knight>(const Pos from, const Player color) const -> std::vector<Pos>
+auto Board::get_moves_by_type<Piece::Type::Knight>(const Pos from, const Player color, TargetBuffer& moves) const -> void
 {
-    std::vector<Pos> moves;
-
-    constexpr std::array<Pos, 8> directions = {
-            Pos{-1, 2}, Pos{1, 2},
-        Pos{-2, 1},             Pos{2, 1},
-                // Horsey here
-        Pos{-2, -1},            Pos{2, -1},
-            Pos{-1, -2}, Pos{1, -2}
-    };
-
-    for (const Pos dir : directions)
+    for (const Square square : m_Tables.knight(from))
     {
-        Pos next = from + dir;
-
-        if (!in_bounds(next, getSize()))
-            continue;
-
+        const Pos next = m_Tables.toPos(square);
         auto piece = find_piece(m_Pieces, next);
 
         if (piece == std::nullopt || piece->color != color)
             moves.push_back(next);
     }
-
-    return moves;
 }
 
 template<>
-auto Board::get_moves_by_type<Piece::Type::Bishop>(const Pos from, const Player /* color */) const -> std::vector<Pos>
+auto Board::get_moves_by_type<Piece::Type::Bishop>(const Pos from, const Player /* color */, TargetBuffer& moves) const -> void
 {
-    std::vector<Pos> moves;
-
-    constexpr std::array<Pos, 4> directions = {
-        Pos{-1, 1},     Pos{1, 1},
-
-        Pos{-1, -1},    Pos{1, -1}
-    };
-
-    for (const Pos dir : directions)
+    for (const auto dir : MoveTables::Diagonal)
         append_moves_in_direction(
             m_Pieces,
+            m_Tables,
             from,
             dir,
-            getSize(),
             moves);
-
-    return moves;
 }
 
 template<>
-auto Board::get_moves_by_type<Piece::Type::Rook>(const Pos from, const Player /* color */) const -> std::vector<Pos>
+auto Board::get_moves_by_type<Piece::Type::Rook>(const Pos from, const Player /* color */, TargetBuffer& moves) const -> void
 {
-    std::vector<Pos> moves;
-
-    constexpr std::array<Pos, 4> directions = {
-                Pos{0, 1},
-        Pos{-1, 0},     Pos{1, 0},
-                Pos{0, -1}
-    };
-
-    for (const Pos dir : directions)
+    for (const auto dir : MoveTables::Straight)
         append_moves_in_direction(
             m_Pieces,
+            m_Tables,
             from,
             dir,
-            getSize(),
             moves);
-
-    return moves;
 }
 
 template<>
-auto Board::get_moves_by_type<Piece::Type::Queen>(const Pos from, const Player /* color */) const -> std::vector<Pos>
+auto Board::get_moves_by_type<Piece::Type::Queen>(const Pos from, const Player /* color */, TargetBuffer& moves) const -> void
 {
-    std::vector<Pos> moves;
-
-    constexpr std::array<Pos, 8> directions = {
-            Pos{-1, 1},     Pos{0, 1},      Pos{1, 1},
-            Pos{-1, 0},                     Pos{1, 0},
-            Pos{-1, -1},    Pos{0, -1},     Pos{1, -1}
-    };
-
-    for (const Pos dir : directions)
+    for (const auto dirs : {MoveTables::Diagonal, MoveTables::Straight})
+    for (const auto dir : dirs)
         append_moves_in_direction(
             m_Pieces,
+            m_Tables,
             from,
             dir,
-            getSize(),
             moves);
-
-    return moves;
 }
 
 template<>
-auto Board::get_moves_by_type<Piece::Type::King>(const Pos from, const Player color) const -> std::vector<Pos>
+auto Board::get_moves_by_type<Piece::Type::King>(const Pos from, const Player color, TargetBuffer& moves) const -> void
 {
-    std::vector<Pos> moves;
-
-    for (int y = -1; y <= 1; y++)
-    for (int x = -1; x <= 1; x++)
+    for (const Square square : m_Tables.king(from))
     {
-        if (x == 0 && y == 0)
-            continue;
-
-        const Pos next_pos = from + Pos{x, y};
-
-        if (!in_bounds(next_pos, getSize()))
-            continue;
-
+        const Pos next_pos = m_Tables.toPos(square);
         auto piece = find_piece(m_Pieces, next_pos);
 
         if (piece == std::nullopt || piece->color != color)
@@ -248,43 +203,34 @@ auto Board::get_moves_by_type<Piece::Type::King>(const Pos from, const Player co
     // Castling
     if (!m_Pieces.at(from).moved)
     {
-        constexpr std::array<Pos, 2> directions = {
-            Pos{-1, 0}, Pos{1, 0}
-        };
-
         for (const Move& move : m_MoveHistory)
             if (move.isType(Move::Type::Check) && move.player != color)
-                return moves;
+                return;
 
-        for (const Pos dir : directions)
+        for (const auto dir : {MoveTables::Direction::West, MoveTables::Direction::East})
         {
-            Pos next = from + dir;
+            const Pos step = MoveTables::Steps[static_cast<int>(dir)];
 
-            while (in_bounds(next, getSize()))
+            const auto ray = m_Tables.ray(from, dir);
+
+            for (std::size_t i = 0; i < ray.size(); i++)
             {
-                auto piece = find_piece(m_Pieces, next);
+                auto piece = find_piece(m_Pieces, m_Tables.toPos(ray[i]));
 
                 if (piece == std::nullopt)
-                {
-                    next += dir;
                     continue;
-                }
 
-                if (piece->type == Piece::Type::Rook && !piece->moved)
-                {
-                    checkIfAttackingPos(
-                        from + dir, color == Player::White ? Player::Black : Player::White);
-                    
-                    moves.push_back(from + dir * 2);
-                }
+                // The rook has to be our own and stand past the king's target square, same as in
+                // Position. Whether the squares are attacked isn't asked here, that would generate the
+                // enemy king's castling, which asks again for ours.
+                if (piece->type == Piece::Type::Rook && !piece->moved && piece->color == color && i >= 2)
+                    moves.push_back(from + step * 2);
 
                 // Break if we found a piece that is not a rook, or a rook that has moved
                 break;
             }
         }
     }
-
-    return moves;
 }
 
 } // namespace Chess
@@ -0,0 +1,255 @@
+#include "Chess/Fill.hpp"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define CHESS_HAS_AVX2 1
+#endif
+
+#include "Chess/Cpu.hpp"
+
+namespace
+{
+
+using Chess::Direction;
+using Chess::MoveTables;
+using Chess::SliderFills;
+
+using BB = SliderFills::BB;
+
+auto shift_scalar(const BB& board, const SliderFills::Shift& shift) -> BB
+{
+    BB result{};
+
+    for (std::size_t i = 0; i < BB::WordCount; i++)
+    {
+        const uint64_t near = board.words[shift.nearIndex[2 * i] / 2] & shift.nearKeep[i];
+        const uint64_t far = board.words[shift.farIndex[2 * i] / 2] & shift.farKeep[i];
+
+        // The far lane only contributes the bits carried over a lane boundary
+        if (shift.up)
+            result.words[i] = (near << shift.count) | (shift.count ? far >> (64 - shift.count) : 0);
+        else
+            result.words[i] = (near >> shift.count) | (shift.count ? far << (64 - shift.count) : 0);
+    }
+
+    return result;
+}
+
+auto fill_scalar(const SliderFills& fills, const Direction dir, const BB& sliders, const BB& empty) -> BB
+{
+    const SliderFills::Ray& ray = fills.ray(dir);
+
+    BB generate = sliders;
+    BB propagate = empty & ray.mask;
+
+    for (int k = 0; k < fills.steps(); k++)
+    {
+        generate |= propagate & shift_scalar(generate, ray.shifts[k]);
+
+        if (k + 1 < fills.steps())
+            propagate &= shift_scalar(propagate, ray.shifts[k]);
+    }
+
+    return shift_scalar(generate, ray.shifts[0]) & ray.mask;
+}
+
+#ifdef CHESS_HAS_AVX2
+__attribute__((target("avx2")))
+auto load(const void* data) -> __m256i
+{
+    return _mm256_load_si256(static_cast<const __m256i*>(data));
+}
+
+__attribute__((target("avx2")))
+auto shift_avx2(const __m256i board, const SliderFills::Shift& shift) -> __m256i
+{
+    const __m256i near = _mm256_and_si256(
+        _mm256_permutevar8x32_epi32(board, load(shift.nearIndex.data())), load(shift.nearKeep.data()));
+    const __m256i far = _mm256_and_si256(
+        _mm256_permutevar8x32_epi32(board, load(shift.farIndex.data())), load(shift.farKeep.data()));
+
+    // Variable shifts by 64 give zero, so a whole lane shift needs no special case
+    const __m256i count = _mm256_set1_epi64x(shift.count);
+    const __m256i carry = _mm256_set1_epi64x(64 - shift.count);
+
+    if (shift.up)
+        return _mm256_or_si256(_mm256_sllv_epi64(near, count), _mm256_srlv_epi64(far, carry));
+
+    return _mm256_or_si256(_mm256_srlv_epi64(near, count), _mm256_sllv_epi64(far, carry));
+}
+
+__attribute__((target("avx2")))
+auto fill_avx2(const SliderFills& fills, const Direction dir, const __m256i sliders, const __m256i empty) -> __m256i
+{
+    const SliderFills::Ray& ray = fills.ray(dir);
+    const __m256i mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ray.mask.words.data()));
+
+    __m256i generate = sliders;
+    __m256i propagate = _mm256_and_si256(empty, mask);
+
+    for (int k = 0; k < fills.steps(); k++)
+    {
+        generate = _mm256_or_si256(generate, _mm256_and_si256(propagate, shift_avx2(generate, ray.shifts[k])));
+
+        if (k + 1 < fills.steps())
+            propagate = _mm256_and_si256(propagate, shift_avx2(propagate, ray.shifts[k]));
+    }
+
+    return _mm256_and_si256(shift_avx2(generate, ray.shifts[0]), mask);
+}
+
+template <typename Directions>
+__attribute__((target("avx2")))
+auto fill_all_avx2(const SliderFills& fills, const Directions& directions, const BB& sliders, const BB& empty) -> BB
+{
+    const __m256i slider_lanes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sliders.words.data()));
+    const __m256i empty_lanes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(empty.words.data()));
+
+    __m256i attacks = _mm256_setzero_si256();
+
+    for (const Direction dir : directions)
+        attacks = _mm256_or_si256(attacks, fill_avx2(fills, dir, slider_lanes, empty_lanes));
+
+    BB result;
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(result.words.data()), attacks);
+
+    return result;
+}
+
+// Lanes shifted in from outside the board are zeroed by the permutes themselves
+__attribute__((target("avx512f,avx512vl")))
+auto shift_avx512(const __m256i board, const SliderFills::Shift& shift) -> __m256i
+{
+    const __m256i near = _mm256_maskz_permutexvar_epi32(shift.nearElements, load(shift.nearIndex.data()), board);
+    const __m256i far = _mm256_maskz_permutexvar_epi32(shift.farElements, load(shift.farIndex.data()), board);
+
+    const __m256i count = _mm256_set1_epi64x(shift.count);
+    const __m256i carry = _mm256_set1_epi64x(64 - shift.count);
+
+    if (shift.up)
+        return _mm256_or_si256(_mm256_sllv_epi64(near, count), _mm256_srlv_epi64(far, carry));
+
+    return _mm256_or_si256(_mm256_srlv_epi64(near, count), _mm256_sllv_epi64(far, carry));
+}
+
+// generate | (propagate & shifted) as a single instruction, 0xF8 is the truth table of a | (b & c)
+__attribute__((target("avx512f,avx512vl")))
+auto fill_avx512(const SliderFills& fills, const Direction dir, const __m256i sliders, const __m256i empty) -> __m256i
+{
+    const SliderFills::Ray& ray = fills.ray(dir);
+    const __m256i mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ray.mask.words.data()));
+
+    __m256i generate = sliders;
+    __m256i propagate = _mm256_and_si256(empty, mask);
+
+    for (int k = 0; k < fills.steps(); k++)
+    {
+        generate = _mm256_ternarylogic_epi64(generate, propagate, shift_avx512(generate, ray.shifts[k]), 0xF8);
+
+        if (k + 1 < fills.steps())
+            propagate = _mm256_and_si256(propagate, shift_avx512(propagate, ray.shifts[k]));
+    }
+
+    return _mm256_and_si256(shift_avx512(generate, ray.shifts[0]), mask);
+}
+
+template <typename Directions>
+__attribute__((target("avx512f,avx512vl")))
+auto fill_all_avx512(const SliderFills& fills, const Directions& directions, const BB& sliders, const BB& empty) -> BB
+{
+    const __m256i slider_lanes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sliders.words.data()));
+    const __m256i empty_lanes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(empty.words.data()));
+
+    __m256i attacks = _mm256_setzero_si256();
+
+    for (const Direction dir : directions)
+        attacks = _mm256_or_si256(attacks, fill_avx512(fills, dir, slider_lanes, empty_lanes));
+
+    BB result;
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(result.words.data()), attacks);
+
+    return result;
+}
+#endif
+
+auto cpu_has_avx2() -> bool
+{
+#ifdef CHESS_HAS_AVX2
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+auto cpu_has_avx512() -> bool
+{
+#ifdef CHESS_HAS_AVX2
+    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl");
+#else
+    return false;
+#endif
+}
+
+template <typename Directions>
+auto fill_all(const SliderFills& fills, const Directions& directions, const BB& sliders, const BB& empty) -> BB
+{
+#ifdef CHESS_HAS_AVX2
+    if (Chess::dispatch.fillKernel == Chess::FillKernel::Avx512)
+        return fill_all_avx512(fills, directions, sliders, empty);
+
+    if (Chess::dispatch.fillKernel == Chess::FillKernel::Avx2)
+        return fill_all_avx2(fills, directions, sliders, empty);
+#endif
+
+    BB attacks{};
+
+    for (const Direction dir : directions)
+        attacks |= fill_scalar(fills, dir, sliders, empty);
+
+    return attacks;
+}
+
+} // namespace
+
+namespace Chess
+{
+
+auto SliderFills::straight(const BB& sliders, const BB& empty) const -> BB
+{
+    return fill_all(*this, MoveTables::Straight, sliders, empty);
+}
+
+auto SliderFills::diagonal(const BB& sliders, const BB& empty) const -> BB
+{
+    return fill_all(*this, MoveTables::Diagonal, sliders, empty);
+}
+
+auto get_fill_kernel() -> FillKernel
+{
+    return dispatch.fillKernel;
+}
+
+auto set_fill_kernel(const FillKernel kernel) -> bool
+{
+    if (kernel == FillKernel::Avx2 && !avx2_supported())
+        return false;
+
+    if (kernel == FillKernel::Avx512 && !avx512_supported())
+        return false;
+
+    dispatch.fillKernel = kernel;
+
+    return true;
+}
+
+auto avx2_supported() -> bool
+{
+    return cpu_has_avx2();
+}
+
+auto avx512_supported() -> bool
+{
+    return cpu_has_avx512();
+}
+
+} // namespace Chess
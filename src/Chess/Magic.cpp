@@ -0,0 +1,307 @@
+#include "Chess/Magic.hpp"
+
+#include <array>
+#include <bit>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define CHESS_HAS_PEXT 1
+#endif
+
+#include "Chess/Cpu.hpp"
+#include "Chess/MoveTables.hpp"
+
+namespace
+{
+
+using Chess::Direction;
+using Chess::MoveTables;
+using Chess::Square;
+
+constexpr auto& tables = Chess::static_move_tables<8, 8>;
+
+// Attacks found by walking the rays, the reference both lookups are built from and checked against
+template <typename Directions>
+auto walk_rays(const Square square, const uint64_t occupied, const Directions& directions) -> uint64_t
+{
+    uint64_t attacks = 0;
+
+    for (const Direction dir : directions)
+        for (const Square to : tables.ray(square, dir))
+        {
+            attacks |= uint64_t{1} << to;
+
+            if ((occupied >> to) & 1)
+                break;
+        }
+
+    return attacks;
+}
+
+// Squares whose occupancy changes the attacks, the last square of a ray is attacked either way
+template <typename Directions>
+auto relevant_mask(const Square square, const Directions& directions) -> uint64_t
+{
+    uint64_t mask = 0;
+
+    for (const Direction dir : directions)
+    {
+        const auto ray = tables.ray(square, dir);
+
+        for (std::size_t i = 0; i + 1 < ray.size(); i++)
+            mask |= uint64_t{1} << ray[i];
+    }
+
+    return mask;
+}
+
+// Portable parallel bit extract, only used to fill the PEXT tables
+auto extract_bits(const uint64_t value, uint64_t mask) -> uint64_t
+{
+    uint64_t result = 0;
+
+    for (uint64_t bit = 1; mask; bit <<= 1)
+    {
+        if (value & mask & -mask)
+            result |= bit;
+
+        mask &= mask - 1;
+    }
+
+    return result;
+}
+
+struct SliderEntry
+{
+    uint64_t mask;
+    uint64_t magic;
+    // Start of the square's attacks, same for both tables
+    uint32_t offset;
+    uint8_t shift;
+};
+
+struct SliderTables
+{
+    std::array<SliderEntry, 64> rook;
+    std::array<SliderEntry, 64> bishop;
+
+    std::vector<uint64_t> magic_attacks;
+    std::vector<uint64_t> pext_attacks;
+};
+
+auto next_random(uint64_t& state) -> uint64_t
+{
+    // xorshift64*
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+
+    return state * 0x2545F4914F6CDD1Dull;
+}
+
+template <typename Directions>
+auto build_square(
+    const Square square,
+    const Directions& directions,
+    SliderEntry& entry,
+    SliderTables& slider_tables,
+    uint64_t& seed) -> void
+{
+    const uint64_t mask = relevant_mask(square, directions);
+    const int bits = std::popcount(mask);
+    const std::size_t size = std::size_t{1} << bits;
+
+    entry.mask = mask;
+    entry.shift = 64 - bits;
+    entry.offset = slider_tables.magic_attacks.size();
+
+    std::vector<uint64_t> occupancies(size);
+    std::vector<uint64_t> attacks(size);
+
+    // Enumerate every subset of the mask (carry-rippler)
+    uint64_t occupied = 0;
+
+    for (std::size_t i = 0; i < size; i++)
+    {
+        occupancies[i] = occupied;
+        attacks[i] = walk_rays(square, occupied, directions);
+
+        occupied = (occupied - mask) & mask;
+    }
+
+    slider_tables.pext_attacks.resize(entry.offset + size);
+
+    for (std::size_t i = 0; i < size; i++)
+        slider_tables.pext_attacks[entry.offset + extract_bits(occupancies[i], mask)] = attacks[i];
+
+    // Try sparse random numbers until one maps every occupancy without a harmful collision
+    std::vector<uint64_t> used(size);
+    std::vector<uint32_t> tried_in(size, 0);
+
+    for (uint32_t attempt = 1;; attempt++)
+    {
+        const uint64_t magic = next_random(seed) & next_random(seed) & next_random(seed);
+
+        if (std::popcount((mask * magic) >> 56) < 6)
+            continue;
+
+        bool collision = false;
+
+        for (std::size_t i = 0; i < size && !collision; i++)
+        {
+            const std::size_t index = (occupancies[i] * magic) >> entry.shift;
+
+            if (tried_in[index] != attempt)
+            {
+                tried_in[index] = attempt;
+                used[index] = attacks[i];
+            }
+            else if (used[index] != attacks[i])
+            {
+                collision = true;
+            }
+        }
+
+        if (collision)
+            continue;
+
+        entry.magic = magic;
+
+        for (std::size_t i = 0; i < size; i++)
+            if (tried_in[i] != attempt)
+                used[i] = 0;
+
+        slider_tables.magic_attacks.insert(slider_tables.magic_attacks.end(), used.begin(), used.end());
+
+        return;
+    }
+}
+
+auto build_tables() -> SliderTables
+{
+    SliderTables slider_tables{};
+
+    // Fixed seed per rank, the same magics are found on every run and none of them needs a long search
+    constexpr std::array<uint64_t, 8> seeds = {728, 10316, 55013, 32803, 12281, 15100, 16645, 255};
+
+    for (Square square = 0; square < 64; square++)
+    {
+        uint64_t seed = seeds[square / 8];
+        build_square(square, MoveTables::Straight, slider_tables.rook[square], slider_tables, seed);
+    }
+
+    for (Square square = 0; square < 64; square++)
+    {
+        uint64_t seed = seeds[square / 8];
+        build_square(square, MoveTables::Diagonal, slider_tables.bishop[square], slider_tables, seed);
+    }
+
+    return slider_tables;
+}
+
+auto cpu_has_bmi2() -> bool
+{
+#ifdef CHESS_HAS_PEXT
+    return __builtin_cpu_supports("bmi2");
+#else
+    return false;
+#endif
+}
+
+const SliderTables slider_tables = build_tables();
+
+auto magic_lookup(const SliderEntry& entry, const uint64_t occupied) -> uint64_t
+{
+    return slider_tables.magic_attacks[entry.offset + (((occupied & entry.mask) * entry.magic) >> entry.shift)];
+}
+
+#ifdef CHESS_HAS_PEXT
+__attribute__((target("bmi2")))
+auto pext_lookup(const SliderEntry& entry, const uint64_t occupied) -> uint64_t
+{
+    return slider_tables.pext_attacks[entry.offset + _pext_u64(occupied, entry.mask)];
+}
+#endif
+
+auto lookup(const SliderEntry& entry, const uint64_t occupied) -> uint64_t
+{
+#ifdef CHESS_HAS_PEXT
+    if (Chess::dispatch.sliderLookup == Chess::SliderLookup::Pext)
+        return pext_lookup(entry, occupied);
+#endif
+
+    return magic_lookup(entry, occupied);
+}
+
+} // namespace
+
+namespace Chess
+{
+
+auto rook_attacks(const Square square, const uint64_t occupied) -> uint64_t
+{
+    return lookup(slider_tables.rook[square], occupied);
+}
+
+auto bishop_attacks(const Square square, const uint64_t occupied) -> uint64_t
+{
+    return lookup(slider_tables.bishop[square], occupied);
+}
+
+auto get_slider_lookup() -> SliderLookup
+{
+    return dispatch.sliderLookup;
+}
+
+auto set_slider_lookup(const SliderLookup lookup) -> bool
+{
+    if (lookup == SliderLookup::Pext && !pext_supported())
+        return false;
+
+    dispatch.sliderLookup = lookup;
+
+    return true;
+}
+
+auto pext_supported() -> bool
+{
+    return cpu_has_bmi2();
+}
+
+auto validate_slider_attacks() -> bool
+{
+    const SliderLookup previous = dispatch.sliderLookup;
+
+    std::vector<SliderLookup> lookups{SliderLookup::Magic};
+
+    if (pext_supported())
+        lookups.push_back(SliderLookup::Pext);
+
+    bool valid = true;
+
+    for (const SliderLookup tested : lookups)
+    {
+        dispatch.sliderLookup = tested;
+        uint64_t seed = 0xC0FFEEull;
+
+        for (Square square = 0; square < 64 && valid; square++)
+        for (int i = 0; i < 4096 && valid; i++)
+        {
+            // Vary the density, from nearly empty to nearly full boards
+            uint64_t occupied = next_random(seed);
+
+            for (int j = 0; j < i % 4; j++)
+                occupied &= next_random(seed);
+
+            valid = rook_attacks(square, occupied) == walk_rays(square, occupied, MoveTables::Straight)
+                && bishop_attacks(square, occupied) == walk_rays(square, occupied, MoveTables::Diagonal);
+        }
+    }
+
+    dispatch.sliderLookup = previous;
+
+    return valid;
+}
+
+} // namespace Chess
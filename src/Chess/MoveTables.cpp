@@ -0,0 +1,25 @@
+#include "Chess/MoveTables.hpp"
+
+namespace Chess
+{
+
+MoveTables::MoveTables(const Pos size)
+    : m_Width{size.x}
+{
+    const int squares = size.x * size.y;
+
+    m_Positions.reserve(squares);
+    m_Offsets.reserve(squares * ListsPerSquare + 1);
+
+    for (int y = 0; y < size.y; y++)
+    for (int x = 0; x < size.x; x++)
+        m_Positions.push_back(Pos{x, y});
+
+    visit_move_lists(size.x, size.y,
+        [&]{ m_Offsets.push_back(m_Targets.size()); },
+        [&](const Square square) { m_Targets.push_back(square); });
+
+    m_Offsets.push_back(m_Targets.size());
+}
+
+} // namespace Chess
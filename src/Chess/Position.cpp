@@ -0,0 +1,828 @@
+#include "Chess/Position.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdlib>
+#include <span>
+#include <vector>
+
+#include "Chess/Arena.hpp"
+#include "Chess/Board.hpp"
+#include "Chess/Magic.hpp"
+#include "Jobs/Pool.hpp"
+#include "Profiling/Allocations.hpp"
+
+namespace
+{
+
+using Chess::Piece;
+using Chess::Player;
+using Chess::Square;
+
+constexpr std::size_t MaxSquares = 256;
+
+struct ZobristKeys
+{
+    // Indexed by piece code, code 0 (empty square) is never used
+    std::array<std::array<uint64_t, MaxSquares>, 13> pieces;
+    std::array<uint64_t, MaxSquares> unmoved;
+    std::array<uint64_t, MaxSquares> enPassant;
+    std::array<uint64_t, 2> checked;
+    uint64_t side;
+};
+
+constexpr auto generate_keys() -> ZobristKeys
+{
+    // SplitMix64, fixed seed so hashes are the same between runs
+    uint64_t state = 0x3DC4E55ull;
+
+    auto next = [&state]() -> uint64_t
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    };
+
+    ZobristKeys keys{};
+
+    for (auto& piece : keys.pieces)
+        for (auto& key : piece)
+            key = next();
+
+    for (auto& key : keys.unmoved)
+        key = next();
+
+    for (auto& key : keys.enPassant)
+        key = next();
+
+    keys.checked = {next(), next()};
+    keys.side = next();
+
+    return keys;
+}
+
+constexpr ZobristKeys keys = generate_keys();
+
+constexpr auto piece_code(const Player color, const Piece::Type type) -> uint8_t
+{
+    return 1 + static_cast<int>(type) + 6 * static_cast<int>(color);
+}
+
+constexpr auto type_of(const uint8_t code) -> Piece::Type
+{
+    return static_cast<Piece::Type>((code - 1) % 6);
+}
+
+constexpr auto color_of(const uint8_t code) -> Player
+{
+    return static_cast<Player>((code - 1) / 6);
+}
+
+constexpr auto forward_of(const Player color) -> int
+{
+    return color == Player::White ? 1 : -1;
+}
+
+template <typename Position>
+auto put(Position& position, const Square square, const uint8_t code) -> void
+{
+    position.squares[square] = code;
+    position.pieces[code - 1].set(square);
+    position.colors[static_cast<int>(color_of(code))].set(square);
+    position.hash ^= keys.pieces[code][square];
+}
+
+template <typename Position>
+auto remove(Position& position, const Square square) -> uint8_t
+{
+    const uint8_t code = position.squares[square];
+
+    position.squares[square] = 0;
+    position.pieces[code - 1].reset(square);
+    position.colors[static_cast<int>(color_of(code))].reset(square);
+    position.hash ^= keys.pieces[code][square];
+
+    return code;
+}
+
+template <typename Position>
+auto clear_unmoved(Position& position, const Square square) -> void
+{
+    if (!position.unmoved.test(square))
+        return;
+
+    position.unmoved.reset(square);
+    position.hash ^= keys.unmoved[square];
+}
+
+// Adds a move to a square if it's empty or holds an enemy piece, returns false if the square is occupied
+template <typename Position>
+auto add_target(const Position& position, const Square from, const Square to, typename Position::MoveList& moves) -> bool
+{
+    const uint8_t code = position.squares[to];
+
+    if (code == 0)
+    {
+        moves.push_back({from, to, 0, Chess::PackedMove::Quiet});
+        return true;
+    }
+
+    if (color_of(code) != position.side)
+        moves.push_back({from, to, 0, Chess::PackedMove::Capture});
+
+    return false;
+}
+
+template <typename Position>
+auto add_pawn_moves(const Position& position, const Square from, typename Position::MoveList& moves) -> void
+{
+    using Chess::PackedMove;
+
+    const Chess::Pos pos = position.toPos(from);
+    const int forward = forward_of(position.side);
+    const int last_rank = position.side == Player::White ? position.height() - 1 : 0;
+    const int y = pos.y + forward;
+
+    if (y < 0 || y >= position.height())
+        return;
+
+    auto add = [&](const Square to, uint8_t flags)
+    {
+        uint8_t promotion = 0;
+
+        // Board only ever promotes to a queen
+        if (to / position.width() == last_rank)
+        {
+            flags |= PackedMove::Promotion;
+            promotion = static_cast<uint8_t>(Piece::Type::Queen);
+        }
+
+        moves.push_back({from, to, promotion, flags});
+    };
+
+    // Move forward
+    const Square one = from + forward * position.width();
+
+    if (position.squares[one] == 0)
+    {
+        add(one, PackedMove::Quiet);
+
+        // Move two squares forward
+        const int y2 = y + forward;
+
+        if (position.unmoved.test(from) && y2 >= 0 && y2 < position.height())
+        {
+            const Square two = one + forward * position.width();
+
+            if (position.squares[two] == 0)
+                add(two, PackedMove::DoublePush);
+        }
+    }
+
+    // Capture
+    for (int dx = -1; dx <= 1; dx += 2)
+    {
+        const int x = pos.x + dx;
+
+        if (x < 0 || x >= position.width())
+            continue;
+
+        const Square to = y * position.width() + x;
+        const uint8_t code = position.squares[to];
+
+        if (code != 0 && color_of(code) != position.side)
+            add(to, PackedMove::Capture);
+    }
+
+    // En passant
+    if (position.enPassant != Chess::NoSquare)
+    {
+        const Chess::Pos victim = position.toPos(position.enPassant);
+
+        if (victim.y == pos.y && std::abs(victim.x - pos.x) == 1)
+            add(y * position.width() + victim.x, PackedMove::Capture | PackedMove::EnPassant);
+    }
+}
+
+template <typename Position>
+auto add_step_moves(const Position& position, const Square from, const std::span<const Square> targets, typename Position::MoveList& moves) -> void
+{
+    for (const Square to : targets)
+        add_target(position, from, to, moves);
+}
+
+template <typename Position, typename Directions>
+auto add_slider_moves(const Position& position, const Square from, const Directions& directions, typename Position::MoveList& moves) -> void
+{
+    for (const Chess::Direction dir : directions)
+        for (const Square to : position.tables().ray(from, dir))
+            if (!add_target(position, from, to, moves))
+                break;
+}
+
+// Squares attacked along the rays, each ray stops at the first piece (that square is included)
+template <typename Position, typename Directions>
+auto walk_attacks(const Position& position, const Square from, const Directions& directions, typename Position::BB& attacks) -> void
+{
+    for (const Chess::Direction dir : directions)
+        for (const Square to : position.tables().ray(from, dir))
+        {
+            attacks.set(to);
+
+            if (position.squares[to] != 0)
+                break;
+        }
+}
+
+// Adds a move to every attacked square not holding an own piece
+template <typename Position>
+auto add_attack_moves(const Position& position, const Square from, typename Position::BB attacks, typename Position::MoveList& moves) -> void
+{
+    const auto& enemy = position.colors[static_cast<int>(!position.side)];
+
+    attacks &= ~position.colors[static_cast<int>(position.side)];
+
+    while (attacks.any())
+    {
+        const Square to = attacks.popFirst();
+
+        moves.push_back({from, to, 0, enemy.test(to) ? Chess::PackedMove::Capture : Chess::PackedMove::Quiet});
+    }
+}
+
+// Sliding moves along diagonals and/or straight lines. They are looked up on 8x8 boards, filled
+// on 256-square boards if a fill kernel was picked and walked square by square otherwise.
+template <typename Position>
+auto add_sliding_moves(const Position& position, const Square from, const bool diagonal, const bool straight, typename Position::MoveList& moves) -> void
+{
+    using Geometry = typename Position::Geometry;
+    using BB = typename Position::BB;
+
+    if constexpr (Geometry::Standard)
+    {
+        const uint64_t occupied = (position.colors[0] | position.colors[1]).words[0];
+        BB attacks{};
+
+        if (diagonal)
+            attacks.words[0] |= Chess::bishop_attacks(from, occupied);
+
+        if (straight)
+            attacks.words[0] |= Chess::rook_attacks(from, occupied);
+
+        add_attack_moves(position, from, attacks, moves);
+    }
+    else if constexpr (Geometry::Wide)
+    {
+        // Collected into a bitboard first, so the moves come in the same order as with the fills
+        if (Chess::get_fill_kernel() == Chess::FillKernel::None)
+        {
+            BB attacks{};
+
+            if (diagonal)
+                walk_attacks(position, from, Chess::MoveTables::Diagonal, attacks);
+
+            if (straight)
+                walk_attacks(position, from, Chess::MoveTables::Straight, attacks);
+
+            add_attack_moves(position, from, attacks, moves);
+
+            return;
+        }
+
+        const BB empty = ~(position.colors[0] | position.colors[1]);
+        BB piece{};
+        BB attacks{};
+
+        piece.set(from);
+
+        if (diagonal)
+            attacks |= Geometry::fills().diagonal(piece, empty);
+
+        if (straight)
+            attacks |= Geometry::fills().straight(piece, empty);
+
+        add_attack_moves(position, from, attacks, moves);
+    }
+    else
+    {
+        if (diagonal)
+            add_slider_moves(position, from, Chess::MoveTables::Diagonal, moves);
+
+        if (straight)
+            add_slider_moves(position, from, Chess::MoveTables::Straight, moves);
+    }
+}
+
+template <typename Position>
+auto add_castling_moves(const Position& position, const Square from, typename Position::MoveList& moves) -> void
+{
+    const int us = static_cast<int>(position.side);
+
+    if (!position.unmoved.test(from) || (position.checked & (1 << us)))
+        return;
+
+    for (const Chess::Direction dir : {Chess::Direction::West, Chess::Direction::East})
+    {
+        const auto ray = position.tables().ray(from, dir);
+
+        for (std::size_t i = 0; i < ray.size(); i++)
+        {
+            const uint8_t code = position.squares[ray[i]];
+
+            if (code == 0)
+                continue;
+
+            // The rook has to be our own and stand past the king's target square, same as in Board
+            if (code == piece_code(position.side, Piece::Type::Rook)
+                && position.unmoved.test(ray[i])
+                && i >= 2)
+                moves.push_back({from, ray[1], 0, Chess::PackedMove::Castling});
+
+            break;
+        }
+    }
+}
+
+// Checks if the piece standing on a square attacks the target square
+template <typename Position>
+auto piece_attacks(const Position& position, const Square square, const Square target) -> bool
+{
+    const uint8_t code = position.squares[square];
+    const Chess::Pos from = position.toPos(square);
+    const Chess::Pos to = position.toPos(target);
+    const int dx = to.x - from.x;
+    const int dy = to.y - from.y;
+
+    switch (type_of(code))
+    {
+        case Piece::Type::Pawn:
+            return dy == forward_of(color_of(code)) && std::abs(dx) == 1;
+        case Piece::Type::Knight:
+            return std::abs(dx * dy) == 2;
+        case Piece::Type::King:
+            return std::max(std::abs(dx), std::abs(dy)) == 1;
+        default:
+            break;
+    }
+
+    const bool straight = dx == 0 || dy == 0;
+    const bool diagonal = std::abs(dx) == std::abs(dy);
+
+    if ((dx == 0 && dy == 0)
+        || (type_of(code) == Piece::Type::Rook && !straight)
+        || (type_of(code) == Piece::Type::Bishop && !diagonal)
+        || (!straight && !diagonal))
+        return false;
+
+    const int step_x = (dx > 0) - (dx < 0);
+    const int step_y = (dy > 0) - (dy < 0);
+
+    for (int x = from.x + step_x, y = from.y + step_y; x != to.x || y != to.y; x += step_x, y += step_y)
+        if (position.squares[y * position.width() + x] != 0)
+            return false;
+
+    return true;
+}
+
+// Finds the rook a castling king jumps over, it's the first piece past the king's target square
+template <typename Position>
+auto find_castling_rook(const Position& position, const Chess::PackedMove& move) -> Square
+{
+    const int dir = move.to > move.from ? 1 : -1;
+
+    Square rook = move.to;
+
+    while (position.squares[rook] == 0)
+        rook += dir;
+
+    return rook;
+}
+
+} // namespace
+
+namespace Chess
+{
+
+template <int Width, int Height>
+auto BasicPosition<Width, Height>::fromBoard(const Board& board) -> BasicPosition
+{
+    assert(BasicPosition::fits(board.getSize()) && "Board doesn't fit into the position");
+
+    BasicPosition position{};
+
+    position.setGeometry(board);
+    position.enPassant = NoSquare;
+    position.kings = {NoSquare, NoSquare};
+
+    for (const auto& [pos, piece] : board.getPieces())
+    {
+        const Square square = position.toSquare(pos);
+
+        put(position, square, piece_code(piece.color, piece.type));
+
+        if (!piece.moved)
+        {
+            position.unmoved.set(square);
+            position.hash ^= keys.unmoved[square];
+        }
+
+        if (piece.type == Piece::Type::King)
+            position.kings[static_cast<int>(piece.color)] = square;
+    }
+
+    position.side = board.getCurrentTurn();
+
+    if (position.side == Player::Black)
+        position.hash ^= keys.side;
+
+    const Board::MoveList& history = board.getMoveHistory();
+
+    for (const Move& move : history)
+    {
+        if (move.isType(Move::Type::Check))
+        {
+            const int color = static_cast<int>(!move.player);
+
+            if (!(position.checked & (1 << color)))
+                position.hash ^= keys.checked[color];
+
+            position.checked |= 1 << color;
+        }
+
+        if (move.piece == Piece::Type::Pawn || move.isType(Move::Type::Capture))
+            position.halfmoveClock = 0;
+        else
+            position.halfmoveClock++;
+    }
+
+    if (!history.empty())
+    {
+        const Move& last_move = history.back();
+
+        if (last_move.piece == Piece::Type::Pawn
+            && last_move.isType(Move::Type::FirstMove)
+            && std::abs(last_move.from.y - last_move.to.y) == 2)
+        {
+            position.enPassant = position.toSquare(last_move.to);
+            position.hash ^= keys.enPassant[position.enPassant];
+        }
+    }
+
+    position.ply = history.size();
+
+    return position;
+}
+
+template <int Width, int Height>
+auto BasicPosition<Width, Height>::generateMoves(MoveList& moves) const -> void
+{
+    // Search and perft rely on positions never touching the heap
+    ASSERT_NO_ALLOCATIONS("BasicPosition::generateMoves");
+
+    BB own = colors[static_cast<int>(side)];
+
+    while (own.any())
+    {
+        const Square from = own.popFirst();
+
+        switch (type_of(squares[from]))
+        {
+            case Piece::Type::Pawn:
+                add_pawn_moves(*this, from, moves);
+                break;
+            case Piece::Type::Knight:
+                add_step_moves(*this, from, tables().knight(from), moves);
+                break;
+            case Piece::Type::Bishop:
+                add_sliding_moves(*this, from, true, false, moves);
+                break;
+            case Piece::Type::Rook:
+                add_sliding_moves(*this, from, false, true, moves);
+                break;
+            case Piece::Type::Queen:
+                add_sliding_moves(*this, from, true, true, moves);
+                break;
+            case Piece::Type::King:
+                add_step_moves(*this, from, tables().king(from), moves);
+                add_castling_moves(*this, from, moves);
+                break;
+        }
+    }
+}
+
+template <int Width, int Height>
+auto BasicPosition<Width, Height>::generateLegalMoves(MoveList& moves) const -> void
+{
+    generateMoves(moves);
+
+    std::size_t legal = 0;
+
+    for (const PackedMove& move : moves)
+        if (!after(move).leftKingAttacked())
+            moves[legal++] = move;
+
+    moves.resize(legal);
+}
+
+template <int Width, int Height>
+auto BasicPosition<Width, Height>::isAttacked(const Square square, const Player by) const -> bool
+{
+    const Pos pos = toPos(square);
+
+    // Pawns attack diagonally forward, so look diagonally backward from the square
+    const uint8_t pawn = piece_code(by, Piece::Type::Pawn);
+    const int behind = pos.y - forward_of(by);
+
+    if (behind >= 0 && behind < height())
+    {
+        if (pos.x > 0 && squares[behind * width() + pos.x - 1] == pawn)
+            return true;
+
+        if (pos.x < width() - 1 && squares[behind * width() + pos.x + 1] == pawn)
+            return true;
+    }
+
+    const uint8_t knight = piece_code(by, Piece::Type::Knight);
+
+    for (const Square from : tables().knight(square))
+        if (squares[from] == knight)
+            return true;
+
+    const uint8_t king = piece_code(by, Piece::Type::King);
+
+    for (const Square from : tables().king(square))
+        if (squares[from] == king)
+            return true;
+
+    const uint8_t queen = piece_code(by, Piece::Type::Queen);
+
+    if constexpr (Geometry::Standard)
+    {
+        const uint64_t occupied = (colors[0] | colors[1]).words[0];
+        const uint64_t queens = pieces[queen - 1].words[0];
+        const uint64_t bishops = pieces[piece_code(by, Piece::Type::Bishop) - 1].words[0];
+        const uint64_t rooks = pieces[piece_code(by, Piece::Type::Rook) - 1].words[0];
+
+        return (bishop_attacks(square, occupied) & (bishops | queens))
+            || (rook_attacks(square, occupied) & (rooks | queens));
+    }
+
+    // Filling from a single square costs more than walking the rays until the first piece,
+    // so larger boards keep walking here
+    auto slider_on_ray = [&](const Direction dir, const uint8_t slider) -> bool
+    {
+        for (const Square from : tables().ray(square, dir))
+            if (squares[from] != 0)
+                return squares[from] == slider || squares[from] == queen;
+
+        return false;
+    };
+
+    for (const Direction dir : MoveTables::Diagonal)
+        if (slider_on_ray(dir, piece_code(by, Piece::Type::Bishop)))
+            return true;
+
+    for (const Direction dir : MoveTables::Straight)
+        if (slider_on_ray(dir, piece_code(by, Piece::Type::Rook)))
+            return true;
+
+    return false;
+}
+
+template <int Width, int Height>
+auto BasicPosition<Width, Height>::make(const PackedMove& move) -> void
+{
+    ASSERT_NO_ALLOCATIONS("BasicPosition::make");
+
+    const Player us = side;
+    const Player them = !side;
+    const uint8_t moving = squares[move.from];
+    const Square rook_from = move.isFlag(PackedMove::Castling) ? find_castling_rook(*this, move) : NoSquare;
+
+    if (enPassant != NoSquare)
+    {
+        hash ^= keys.enPassant[enPassant];
+        enPassant = NoSquare;
+    }
+
+    halfmoveClock++;
+
+    if (move.isFlag(PackedMove::Capture))
+    {
+        const Square captured = move.isFlag(PackedMove::EnPassant)
+            ? static_cast<Square>(move.from - move.from % width() + move.to % width())
+            : move.to;
+
+        remove(*this, captured);
+        clear_unmoved(*this, captured);
+
+        halfmoveClock = 0;
+    }
+
+    remove(*this, move.from);
+    clear_unmoved(*this, move.from);
+
+    put(*this, move.to, move.isFlag(PackedMove::Promotion)
+        ? piece_code(us, static_cast<Piece::Type>(move.promotion))
+        : moving);
+
+    if (type_of(moving) == Piece::Type::Pawn)
+        halfmoveClock = 0;
+
+    if (move.isFlag(PackedMove::DoublePush))
+    {
+        enPassant = move.to;
+        hash ^= keys.enPassant[enPassant];
+    }
+
+    if (type_of(moving) == Piece::Type::King)
+        kings[static_cast<int>(us)] = move.to;
+
+    if (move.isFlag(PackedMove::Castling))
+    {
+        const Square rook_to = move.to > move.from ? move.to - 1 : move.to + 1;
+
+        put(*this, rook_to, remove(*this, rook_from));
+        clear_unmoved(*this, rook_from);
+    }
+
+    side = them;
+    hash ^= keys.side;
+    ply++;
+
+    // A check by the moved piece takes away the opponent's right to castle, same as in Board
+    const int them_bit = 1 << static_cast<int>(them);
+
+    if (!(checked & them_bit) && piece_attacks(*this, move.to, kings[static_cast<int>(them)]))
+    {
+        checked |= them_bit;
+        hash ^= keys.checked[static_cast<int>(them)];
+    }
+}
+
+template <int Width, int Height>
+auto BasicPosition<Width, Height>::make(const PackedMove& move, Undo& undo) -> void
+{
+    undo.hash = hash;
+    undo.unmoved = unmoved;
+    undo.enPassant = enPassant;
+    undo.halfmoveClock = halfmoveClock;
+    undo.checked = checked;
+    undo.captured = 0;
+
+    if (move.isFlag(PackedMove::EnPassant))
+        undo.captured = squares[enPassant];
+    else if (move.isFlag(PackedMove::Capture))
+        undo.captured = squares[move.to];
+
+    undo.rookFrom = move.isFlag(PackedMove::Castling) ? find_castling_rook(*this, move) : NoSquare;
+
+    make(move);
+}
+
+template <int Width, int Height>
+auto BasicPosition<Width, Height>::unmake(const PackedMove& move, const Undo& undo) -> void
+{
+    ASSERT_NO_ALLOCATIONS("BasicPosition::unmake");
+
+    side = !side;
+    ply--;
+
+    const Player us = side;
+
+    if (move.isFlag(PackedMove::Castling))
+    {
+        const Square rook_to = move.to > move.from ? move.to - 1 : move.to + 1;
+
+        put(*this, undo.rookFrom, remove(*this, rook_to));
+    }
+
+    const uint8_t moved = remove(*this, move.to);
+
+    put(*this, move.from, move.isFlag(PackedMove::Promotion)
+        ? piece_code(us, Piece::Type::Pawn)
+        : moved);
+
+    if (type_of(moved) == Piece::Type::King)
+        kings[static_cast<int>(us)] = move.from;
+
+    if (move.isFlag(PackedMove::EnPassant))
+        put(*this, undo.enPassant, undo.captured);
+    else if (move.isFlag(PackedMove::Capture))
+        put(*this, move.to, undo.captured);
+
+    hash = undo.hash;
+    unmoved = undo.unmoved;
+    enPassant = undo.enPassant;
+    halfmoveClock = undo.halfmoveClock;
+    checked = undo.checked;
+}
+
+template <typename Position>
+auto perftCopyMake(const Position& position, const int depth) -> uint64_t
+{
+    if (depth == 0)
+        return 1;
+
+    // The move list lives in the thread's arena until this ply returns
+    Arena& arena = Arena::local();
+    const Arena::Frame frame{arena};
+
+    auto& moves = arena.create<typename Position::MoveList>();
+    position.generateMoves(moves);
+
+    uint64_t nodes = 0;
+
+    for (const PackedMove& move : moves)
+    {
+        const Position next = position.after(move);
+
+        if (next.leftKingAttacked())
+            continue;
+
+        nodes += perftCopyMake(next, depth - 1);
+    }
+
+    return nodes;
+}
+
+template <typename Position>
+auto perftMakeUnmake(Position& position, const int depth) -> uint64_t
+{
+    if (depth == 0)
+        return 1;
+
+    Arena& arena = Arena::local();
+    const Arena::Frame frame{arena};
+
+    auto& moves = arena.create<typename Position::MoveList>();
+    position.generateMoves(moves);
+
+    uint64_t nodes = 0;
+    auto& undo = arena.create<typename Position::Undo>();
+
+    for (const PackedMove& move : moves)
+    {
+        position.make(move, undo);
+
+        if (!position.leftKingAttacked())
+            nodes += perftMakeUnmake(position, depth - 1);
+
+        position.unmake(move, undo);
+    }
+
+    return nodes;
+}
+
+template <typename Position>
+auto perftParallel(const Position& position, const int depth) -> uint64_t
+{
+    if (depth <= 1)
+        return perftCopyMake(position, depth);
+
+    Arena& arena = Arena::local();
+    const Arena::Frame frame{arena};
+
+    auto& moves = arena.create<typename Position::MoveList>();
+    position.generateMoves(moves);
+
+    std::vector<uint64_t> nodes(moves.size(), 0);
+
+    // One root move per task, subtrees differ a lot in size so stealing evens them out
+    Jobs::parallel_for(moves.size(), 1, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; i++)
+        {
+            const Position next = position.after(moves[i]);
+
+            if (!next.leftKingAttacked())
+                nodes[i] = perftCopyMake(next, depth - 1);
+        }
+    });
+
+    uint64_t total = 0;
+
+    for (const uint64_t count : nodes)
+        total += count;
+
+    return total;
+}
+
+template struct BasicPosition<8, 8>;
+template struct BasicPosition<16, 16>;
+template struct BasicPosition<Dynamic, Dynamic>;
+
+template auto perftCopyMake(const Position8&, int) -> uint64_t;
+template auto perftCopyMake(const Position16&, int) -> uint64_t;
+template auto perftCopyMake(const PositionN&, int) -> uint64_t;
+template auto perftParallel(const Position8&, int) -> uint64_t;
+template auto perftParallel(const Position16&, int) -> uint64_t;
+template auto perftParallel(const PositionN&, int) -> uint64_t;
+template auto perftMakeUnmake(Position8&, int) -> uint64_t;
+template auto perftMakeUnmake(Position16&, int) -> uint64_t;
+template auto perftMakeUnmake(PositionN&, int) -> uint64_t;
+
+} // namespace Chess
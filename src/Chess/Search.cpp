@@ -0,0 +1,455 @@
+#include "Chess/Search.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdlib>
+
+#include "Chess/Arena.hpp"
+#include "Chess/Cpu.hpp"
+#include "Profiling/Stats.hpp"
+
+#if defined(__x86_64__)
+#define CHESS_HAS_ISA_VARIANTS 1
+#endif
+
+namespace
+{
+
+using Chess::PackedMove;
+using Chess::Piece;
+using Chess::Player;
+using Chess::Square;
+
+// Indexed by Piece::Type, the king is never traded so it has no value
+constexpr std::array<int, 6> PieceValues = {100, 330, 320, 500, 900, 0};
+// Cheapest attacker first among captures of the same victim, the king captures last
+constexpr std::array<int, 6> AttackerOrder = {0, 2, 1, 3, 4, 5};
+
+// Move ordering keys: the move from the table first, then captures by most valuable victim and
+// least valuable attacker, then promotions, then everything else in generation order
+constexpr int TableMoveKey = 1 << 24;
+constexpr int CaptureKey = 1 << 20;
+constexpr int PromotionKey = 1 << 16;
+
+// Captures searched after the depth runs out, boards full of pawns that can take each other
+// would otherwise have capture sequences too long to ever finish
+constexpr int QuiescenceDepth = 6;
+
+// Scores this close to MateScore are mates, they are stored relative to the node in the table
+constexpr int MateThreshold = Chess::MateScore - 1024;
+
+constexpr PackedMove NoMove{Chess::NoSquare, Chess::NoSquare, 0, 0};
+
+constexpr auto type_of(const uint8_t code) -> Piece::Type
+{
+    return static_cast<Piece::Type>((code - 1) % 6);
+}
+
+constexpr auto same_move(const PackedMove& a, const PackedMove& b) -> bool
+{
+    return a.from == b.from && a.to == b.to && a.promotion == b.promotion && a.flags == b.flags;
+}
+
+constexpr auto to_table(const int score, const int ply) -> int
+{
+    if (score > MateThreshold)
+        return score + ply;
+
+    if (score < -MateThreshold)
+        return score - ply;
+
+    return score;
+}
+
+constexpr auto from_table(const int score, const int ply) -> int
+{
+    if (score > MateThreshold)
+        return score - ply;
+
+    if (score < -MateThreshold)
+        return score + ply;
+
+    return score;
+}
+
+// Material, plus knights and bishops a little better the closer they are to the middle. Always
+// inlined into the variants below, which compile it for their instruction set.
+template <typename Position>
+[[gnu::always_inline]] inline auto evaluate(const Position& position) -> int
+{
+    int score = 0;
+
+    for (int type = 0; type < 6; type++)
+        score += PieceValues[type] * (position.pieces[type].count() - position.pieces[6 + type].count());
+
+    for (const Player color : {Player::White, Player::Black})
+    for (const Piece::Type type : {Piece::Type::Bishop, Piece::Type::Knight})
+    {
+        const int sign = color == Player::White ? 1 : -1;
+        auto minors = position.pieces[static_cast<int>(color) * 6 + static_cast<int>(type)];
+
+        while (minors.any())
+        {
+            const Chess::Pos pos = position.toPos(static_cast<Square>(minors.popFirst()));
+
+            // Doubled distances, so boards with an even side have a middle too
+            const int distance = std::abs(2 * pos.x - (position.width() - 1))
+                + std::abs(2 * pos.y - (position.height() - 1));
+
+            score -= sign * distance;
+        }
+    }
+
+    return position.side == Player::White ? score : -score;
+}
+
+template <typename Position>
+using Evaluate = int (*)(const Position&);
+
+template <typename Position>
+auto evaluate_scalar(const Position& position) -> int
+{
+    return evaluate(position);
+}
+
+#ifdef CHESS_HAS_ISA_VARIANTS
+// The bit counts and scans of the bitboards become single instructions
+template <typename Position>
+__attribute__((target("sse4.2,popcnt")))
+auto evaluate_sse42(const Position& position) -> int
+{
+    return evaluate(position);
+}
+
+// Nothing in the evaluation uses 512-bit vectors, AVX-512 CPUs run this one too
+template <typename Position>
+__attribute__((target("sse4.2,popcnt,avx2,bmi,bmi2")))
+auto evaluate_avx2(const Position& position) -> int
+{
+    return evaluate(position);
+}
+#endif
+
+template <typename Position>
+auto select_evaluate(const Chess::IsaLevel level) -> Evaluate<Position>
+{
+#ifdef CHESS_HAS_ISA_VARIANTS
+    if (level >= Chess::IsaLevel::Avx2)
+        return evaluate_avx2<Position>;
+
+    if (level >= Chess::IsaLevel::Sse42)
+        return evaluate_sse42<Position>;
+#else
+    static_cast<void>(level);
+#endif
+
+    return evaluate_scalar<Position>;
+}
+
+template <typename Position>
+auto order_key(const Position& position, const PackedMove& move, const PackedMove& table_move) -> int
+{
+    if (same_move(move, table_move))
+        return TableMoveKey;
+
+    int key = 0;
+
+    if (move.isFlag(PackedMove::Capture))
+    {
+        const Piece::Type victim = move.isFlag(PackedMove::EnPassant)
+            ? Piece::Type::Pawn
+            : type_of(position.squares[move.to]);
+        const Piece::Type attacker = type_of(position.squares[move.from]);
+
+        key += CaptureKey + PieceValues[static_cast<int>(victim)] * 8 - AttackerOrder[static_cast<int>(attacker)];
+    }
+
+    if (move.isFlag(PackedMove::Promotion))
+        key += PromotionKey + PieceValues[move.promotion];
+
+    return key;
+}
+
+// Moves the best ordered move left of the first index to it, the rest is left unsorted
+template <typename MoveList>
+auto pick_next(MoveList& moves, int* keys, const std::size_t first) -> void
+{
+    std::size_t best = first;
+
+    for (std::size_t i = first + 1; i < moves.size(); i++)
+        if (keys[i] > keys[best])
+            best = i;
+
+    std::swap(moves[first], moves[best]);
+    std::swap(keys[first], keys[best]);
+}
+
+template <typename Position>
+struct SearchContext
+{
+    Position position;
+    Chess::TranspositionTable& table;
+    // Picked once per search for the current instruction set level
+    Evaluate<Position> evaluate;
+    uint64_t nodes{0};
+    PackedMove best{NoMove};
+
+    // Handed to Profiling::count() once the search is done
+    uint64_t quiescenceNodes{0};
+    uint64_t tableProbes{0};
+    uint64_t tableHits{0};
+    uint64_t betaCutoffs{0};
+    uint64_t firstMoveCutoffs{0};
+};
+
+// Only captures and promotions, the side to move may also stand pat on the static evaluation
+template <typename Position>
+auto quiesce(SearchContext<Position>& context, const int depth, int alpha, const int beta) -> int
+{
+    Position& position = context.position;
+
+    context.nodes++;
+    context.quiescenceNodes++;
+
+    const int stand_pat = context.evaluate(position);
+
+    if (stand_pat >= beta || depth == 0)
+        return stand_pat;
+
+    alpha = std::max(alpha, stand_pat);
+
+    Chess::Arena& arena = Chess::Arena::local();
+    const Chess::Arena::Frame frame{arena};
+
+    auto& moves = arena.create<typename Position::MoveList>();
+    position.generateMoves(moves);
+
+    std::size_t tactical = 0;
+
+    for (const PackedMove& move : moves)
+        if (move.isFlag(PackedMove::Capture) || move.isFlag(PackedMove::Promotion))
+            moves[tactical++] = move;
+
+    moves.resize(tactical);
+
+    int* keys = arena.allocate<int>(moves.size());
+
+    for (std::size_t i = 0; i < moves.size(); i++)
+        keys[i] = order_key(position, moves[i], NoMove);
+
+    auto& undo = arena.create<typename Position::Undo>();
+    int best_score = stand_pat;
+
+    for (std::size_t i = 0; i < moves.size(); i++)
+    {
+        pick_next(moves, keys, i);
+
+        const PackedMove move = moves[i];
+
+        position.make(move, undo);
+
+        if (position.leftKingAttacked())
+        {
+            position.unmake(move, undo);
+            continue;
+        }
+
+        const int score = -quiesce(context, depth - 1, -beta, -alpha);
+
+        position.unmake(move, undo);
+
+        best_score = std::max(best_score, score);
+        alpha = std::max(alpha, score);
+
+        if (alpha >= beta)
+            break;
+    }
+
+    return best_score;
+}
+
+template <typename Position>
+auto negamax(SearchContext<Position>& context, const int depth, const int ply, int alpha, const int beta) -> int
+{
+    if (depth <= 0)
+        return quiesce(context, QuiescenceDepth, alpha, beta);
+
+    Position& position = context.position;
+    Chess::TranspositionTable& table = context.table;
+    using Bound = Chess::TranspositionTable::Bound;
+
+    context.nodes++;
+
+    const int original_alpha = alpha;
+    PackedMove table_move = NoMove;
+
+    context.tableProbes++;
+
+    if (const auto* entry = table.probe(position.hash))
+    {
+        context.tableHits++;
+        table_move = entry->move;
+
+        // The root always searches, it has to come up with a move
+        if (ply > 0 && entry->depth >= depth)
+        {
+            const int score = from_table(entry->score, ply);
+
+            if (entry->bound == Bound::Exact
+                || (entry->bound == Bound::Lower && score >= beta)
+                || (entry->bound == Bound::Upper && score <= alpha))
+                return score;
+        }
+    }
+
+    Chess::Arena& arena = Chess::Arena::local();
+    const Chess::Arena::Frame frame{arena};
+
+    auto& moves = arena.create<typename Position::MoveList>();
+    position.generateMoves(moves);
+
+    int* keys = arena.allocate<int>(moves.size());
+
+    for (std::size_t i = 0; i < moves.size(); i++)
+        keys[i] = order_key(position, moves[i], table_move);
+
+    auto& undo = arena.create<typename Position::Undo>();
+
+    int best_score = -Chess::InfiniteScore;
+    PackedMove best_move = NoMove;
+    std::size_t searched = 0;
+
+    for (std::size_t i = 0; i < moves.size(); i++)
+    {
+        pick_next(moves, keys, i);
+
+        const PackedMove move = moves[i];
+
+        position.make(move, undo);
+
+        if (position.leftKingAttacked())
+        {
+            position.unmake(move, undo);
+            continue;
+        }
+
+        searched++;
+
+        const int score = -negamax(context, depth - 1, ply + 1, -beta, -alpha);
+
+        position.unmake(move, undo);
+
+        if (score > best_score)
+        {
+            best_score = score;
+            best_move = move;
+        }
+
+        alpha = std::max(alpha, score);
+
+        if (alpha >= beta)
+        {
+            context.betaCutoffs++;
+            context.firstMoveCutoffs += searched == 1;
+            break;
+        }
+    }
+
+    // Checkmate or stalemate, a stalemate is a draw like on the board
+    if (searched == 0)
+    {
+        const Player us = position.side;
+        const bool in_check = position.isAttacked(position.kings[static_cast<int>(us)], !us);
+
+        return in_check ? -Chess::MateScore + ply : 0;
+    }
+
+    if (ply == 0)
+        context.best = best_move;
+
+    const Bound bound =
+        best_score >= beta ? Bound::Lower :
+        best_score > original_alpha ? Bound::Exact :
+        Bound::Upper;
+
+    table.store({
+        .key = position.hash,
+        .move = best_move,
+        .score = static_cast<int16_t>(to_table(best_score, ply)),
+        .depth = static_cast<int8_t>(depth),
+        .bound = bound
+    });
+
+    return best_score;
+}
+
+} // namespace
+
+namespace Chess
+{
+
+TranspositionTable::TranspositionTable(const std::size_t megabytes) :
+    m_Entries(std::bit_floor(std::max<std::size_t>(megabytes * 1024 * 1024 / sizeof(Entry), 1))),
+    m_Mask{m_Entries.size() - 1}
+{
+    clear();
+}
+
+auto TranspositionTable::clear() -> void
+{
+    std::fill(m_Entries.begin(), m_Entries.end(), Entry{.key = 0, .move = NoMove, .score = 0, .depth = -1, .bound = Bound::Exact});
+}
+
+auto TranspositionTable::probe(const uint64_t key) const -> const Entry*
+{
+    const Entry& entry = m_Entries[key & m_Mask];
+
+    return entry.key == key && entry.depth >= 0 ? &entry : nullptr;
+}
+
+auto TranspositionTable::store(const Entry& entry) -> void
+{
+    m_Entries[entry.key & m_Mask] = entry;
+}
+
+template <typename Position>
+auto search(const Position& root, const int depth, TranspositionTable& table) -> SearchResult
+{
+    SearchContext<Position> context{
+        .position = root,
+        .table = table,
+        .evaluate = select_evaluate<Position>(get_isa_level())
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    int score = 0;
+
+    // Each iteration leaves its best moves in the table, the next one searches them first
+    for (int iteration = 1; iteration <= depth; iteration++)
+        score = negamax(context, iteration, 0, -InfiniteScore, InfiniteScore);
+
+    using Profiling::Stat;
+
+    Profiling::count(Stat::SearchTime, std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    Profiling::count(Stat::SearchNodes, context.nodes);
+    Profiling::count(Stat::QuiescenceNodes, context.quiescenceNodes);
+    Profiling::count(Stat::TableProbes, context.tableProbes);
+    Profiling::count(Stat::TableHits, context.tableHits);
+    Profiling::count(Stat::BetaCutoffs, context.betaCutoffs);
+    Profiling::count(Stat::FirstMoveCutoffs, context.firstMoveCutoffs);
+
+    return SearchResult{
+        .best = same_move(context.best, NoMove) ? std::nullopt : std::optional{context.best},
+        .score = score,
+        .nodes = context.nodes
+    };
+}
+
+template auto search(const Position8&, int, TranspositionTable&) -> SearchResult;
+template auto search(const Position16&, int, TranspositionTable&) -> SearchResult;
+template auto search(const PositionN&, int, TranspositionTable&) -> SearchResult;
+
+} // namespace Chess
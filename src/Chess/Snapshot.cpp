@@ -0,0 +1,103 @@
+#include "Chess/Snapshot.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+namespace Chess
+{
+
+auto Snapshot::pieceAt(const Pos pos) const -> std::optional<Piece>
+{
+    const auto it = std::find_if(pieces.begin(), pieces.end(),
+        [&](const auto& entry) { return entry.first == pos; });
+
+    if (it == pieces.end())
+        return std::nullopt;
+
+    return it->second;
+}
+
+SnapshotChannel::~SnapshotChannel()
+{
+    // Readers are gone by now, everything can be freed
+    delete m_Current.load();
+
+    for (const auto& [snapshot, epoch] : m_Retired)
+        delete snapshot;
+}
+
+auto SnapshotChannel::publish(std::unique_ptr<const Snapshot> snapshot) -> void
+{
+    const Snapshot* previous = m_Current.exchange(snapshot.release());
+
+    // A reader that still sees the previous snapshot has read an epoch up to this one
+    if (previous)
+        m_Retired.push_back({previous, m_Epoch.load()});
+
+    m_Epoch.fetch_add(1);
+
+    reclaim();
+}
+
+auto SnapshotChannel::reclaim() -> void
+{
+    uint64_t oldest = std::numeric_limits<uint64_t>::max();
+
+    for (const std::atomic<uint64_t>& epoch : m_ReaderEpochs)
+    {
+        const uint64_t seen = epoch.load();
+
+        if (seen != 0)
+            oldest = std::min(oldest, seen);
+    }
+
+    const auto freed = std::remove_if(m_Retired.begin(), m_Retired.end(), [&](const auto& retired)
+    {
+        if (retired.second >= oldest)
+            return false;
+
+        delete retired.first;
+
+        return true;
+    });
+
+    m_Retired.erase(freed, m_Retired.end());
+}
+
+SnapshotChannel::Reader::Reader(SnapshotChannel& channel) :
+    m_Channel{channel},
+    m_Slot{MaxReaders}
+{
+    for (std::size_t slot = 0; slot < MaxReaders; slot++)
+    {
+        bool used = false;
+
+        if (m_Channel.m_ReaderSlots[slot].compare_exchange_strong(used, true))
+        {
+            m_Slot = slot;
+            return;
+        }
+    }
+
+    std::cerr << "Too many snapshot readers, at most " << MaxReaders << " are supported" << std::endl;
+    std::exit(EXIT_FAILURE);
+}
+
+SnapshotChannel::Reader::~Reader()
+{
+    m_Channel.m_ReaderSlots[m_Slot].store(false);
+}
+
+auto SnapshotChannel::Reader::read() const -> View
+{
+    std::atomic<uint64_t>& epoch = m_Channel.m_ReaderEpochs[m_Slot];
+
+    // Announce the epoch before loading, the writer then keeps anything retired from here on
+    epoch.store(m_Channel.m_Epoch.load());
+
+    return View{m_Channel.m_Current.load(), epoch};
+}
+
+} // namespace Chess
@@ -1,9 +1,14 @@
 #include "Controller/Controller.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <format>
 #include <iostream>
+#include <thread>
 
 #include "Controller/GameState.hpp"
+#include "Profiling/Allocations.hpp"
+#include "Profiling/Trace.hpp"
 #include "Common.hpp"
 
 namespace
@@ -122,55 +127,123 @@ constexpr auto fill_camera_setup_sides(CamSetups& setup, const Chess::Pos board_
 namespace Controller
 {
 
-Controller::Controller(Renderer::Camera& camera, Chess::Board& board, GLFWwindow* window) noexcept:
-    m_Camera{camera},
+Controller::Controller(Chess::Board& board, GLFWwindow* window) noexcept:
     m_Board{board},
-    m_Window{window}
+    m_Window{window},
+    m_Snapshots{board.getSnapshots()}
 {
-    m_Keys[GLFW_KEY_Q] = GLFW_RELEASE;
     m_KeyActions[GLFW_KEY_Q] = Action::PreviousCamera;
 
-    m_Keys[GLFW_KEY_E] = GLFW_RELEASE;
     m_KeyActions[GLFW_KEY_E] = Action::NextCamera;
     
-    m_Keys[GLFW_KEY_R] = GLFW_RELEASE;
     m_KeyActions[GLFW_KEY_R] = Action::UndoMove;
 
-    m_Keys[GLFW_KEY_T] = GLFW_RELEASE;
+    m_KeyActions[GLFW_KEY_Y] = Action::RedoMove;
+
     m_KeyActions[GLFW_KEY_T] = Action::ToggleTopView;
 
-    m_Keys[GLFW_KEY_A] = GLFW_RELEASE;
     m_KeyActions[GLFW_KEY_A] = Action::ToggleAutoRotate;
 
-    m_Keys[GLFW_KEY_M] = GLFW_RELEASE;
     m_KeyActions[GLFW_KEY_M] = Action::ResetBoard;
 
+    m_KeyActions[GLFW_KEY_P] = Action::DumpTrace;
+
     fill_camera_setup_top(m_CameraSetupsTop, m_Board.getSize());
     fill_camera_setup_sides(m_CameraSetupsSide, m_Board.getSize());
 
     update_camera();
+    publish_frame();
 }
 
-auto Controller::update() noexcept -> void
+auto Controller::captureInput() noexcept -> void
 {
-    glfwPollEvents();
-    GameState state = m_Board.getCurrentGameState();
+    Input& input = m_Inputs.back();
+
+    glfwGetCursorPos(m_Window, &input.cursor.x, &input.cursor.y);
+    glfwGetWindowSize(m_Window, &input.windowSize.x, &input.windowSize.y);
 
-    if (state != GameState::Playing)
+    std::size_t index = 0;
+
+    for (const auto& [key, action] : m_KeyActions)
     {
+        const KeyState state = glfwGetKey(m_Window, key);
+
+        if (state != m_KeyStates[index] && state == GLFW_PRESS)
+            m_KeyPresses[index]++;
 
+        m_KeyStates[index++] = state;
     }
 
-    handle_mouse_move();
-    
-    handle_action(handle_keyboard());
-    handle_action(handle_mouse_click());
+    const KeyState mouse_state = glfwGetMouseButton(m_Window, GLFW_MOUSE_BUTTON_LEFT);
+
+    if (mouse_state != m_MouseState && mouse_state == GLFW_PRESS)
+        m_Clicks++;
+
+    m_MouseState = mouse_state;
+
+    input.keyPresses = m_KeyPresses;
+    input.clicks = m_Clicks;
+
+    m_Inputs.publish();
+}
+
+auto Controller::update() noexcept -> void
+{
+    if (!m_Inputs.update())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        return;
+    }
+
+    PROFILE_ZONE("Controller::update");
+    PROFILE_ALLOCATIONS("Controller::update");
+
+    const Input& input = m_Inputs.front();
+
+    handle_mouse_move(input);
+
+    handle_keyboard(input);
+    handle_mouse_click(input);
+
+    publish_frame();
+}
+
+auto Controller::getFrame() noexcept -> const FrameState&
+{
+    m_Frames.update();
+
+    return m_Frames.front();
+}
+
+auto Controller::publish_frame() noexcept -> void
+{
+    FrameState& frame = m_Frames.back();
+    const auto snapshot = m_Snapshots.read();
+
+    frame.camera = m_Camera;
+    frame.pieces.assign(snapshot->pieces.begin(), snapshot->pieces.end());
+
+    frame.focused = m_FocusedSquare;
+    frame.selected = m_SelectedSquare;
+    frame.possibleMoves.assign(m_PossibleMoves.begin(), m_PossibleMoves.end());
+    frame.attackingPieces.assign(m_AttackingPieces.begin(), m_AttackingPieces.end());
+
+    // glfwGetTime() may be called from any thread
+    if (snapshot->state == GameState::Playing)
+        m_GameOverTime = 0.0;
+    else if (m_GameOverTime == 0.0)
+        m_GameOverTime = glfwGetTime();
+
+    frame.state = snapshot->state;
+    frame.gameOverTime = m_GameOverTime;
+
+    m_Frames.publish();
 }
 
 auto Controller::update_camera() noexcept -> void
 {
     if (m_CameraAutoRotate)
-        m_CameraSetupIndex = m_Board.getCurrentTurn() == Chess::Player::White ? 0 : 2;
+        m_CameraSetupIndex = m_Snapshots.read()->turn == Chess::Player::White ? 0 : 2;
 
     const CameraSetup& setup = m_CameraTopView ?
         m_CameraSetupsTop[m_CameraSetupIndex] :
@@ -182,13 +255,9 @@ auto Controller::update_camera() noexcept -> void
         m_Camera.pitch(30.f);
 }
 
-auto Controller::handle_mouse_move() noexcept -> void
+auto Controller::handle_mouse_move(const Input& input) noexcept -> void
 {
-    double x, y;
-    glfwGetCursorPos(m_Window, &x, &y);
-
-    int w, h;
-    glfwGetWindowSize(m_Window, &w, &h);
+    PROFILE_ZONE("Controller::handle_mouse_move");
 
     glm::vec3 intersection = find_intersection_with_board(
         m_Camera.getPosition(),
@@ -196,8 +265,8 @@ auto Controller::handle_mouse_move() noexcept -> void
         m_Camera.getUp(),
         m_Camera.getRight(),
         glm::radians(m_Camera.getFov()),
-        {x, y},
-        {w, h}
+        glm::vec2{input.cursor},
+        input.windowSize
     );
 
     const Chess::Pos pos{
@@ -211,46 +280,33 @@ auto Controller::handle_mouse_move() noexcept -> void
         m_FocusedSquare = std::nullopt;
 }
 
-auto Controller::handle_keyboard() noexcept -> Action
+auto Controller::handle_keyboard(const Input& input) noexcept -> void
 {
-    for (auto& [key, state] : m_Keys)
-    {
-        const auto new_state = glfwGetKey(m_Window, key);
-
-        if (state == new_state)
-            continue;
-
-        state = new_state;
+    std::size_t index = 0;
 
-        if (state == GLFW_RELEASE)
-            continue;
+    for (const auto& [key, action] : m_KeyActions)
+    {
+        for (; m_HandledKeyPresses[index] != input.keyPresses[index]; m_HandledKeyPresses[index]++)
+            handle_action(action);
 
-        return m_KeyActions[key];
+        index++;
     }
-
-    return Action::None;
 }
 
-auto Controller::handle_mouse_click() noexcept -> Action
+auto Controller::handle_mouse_click(const Input& input) noexcept -> void
 {
-    static KeyState last_state = GLFW_RELEASE;
-    KeyState state = glfwGetMouseButton(m_Window, GLFW_MOUSE_BUTTON_LEFT);
-
-    if (last_state == state)
-        return Action::None;
-
-    last_state = state;
-
-    if (state == GLFW_RELEASE || !m_FocusedSquare.has_value())
-        return Action::None;
-
-    if (!m_SelectedSquare.has_value())
-        return Action::SelectPiece;
-
-    if (m_SelectedSquare == m_FocusedSquare)
-        return Action::UnselectPiece;
+    for (; m_HandledClicks != input.clicks; m_HandledClicks++)
+    {
+        if (!m_FocusedSquare.has_value())
+            continue;
 
-    return Action::MakeMove;
+        if (!m_SelectedSquare.has_value())
+            handle_action(Action::SelectPiece);
+        else if (m_SelectedSquare == m_FocusedSquare)
+            handle_action(Action::UnselectPiece);
+        else
+            handle_action(Action::MakeMove);
+    }
 }
 
 auto Controller::handle_action(Action action) noexcept -> void
@@ -278,21 +334,18 @@ auto Controller::handle_action(Action action) noexcept -> void
         }
 
         case Action::MakeMove: {
-            Chess::Move* move = nullptr;
+            const auto target = std::find(m_PossibleMoves.begin(), m_PossibleMoves.end(), m_FocusedSquare.value());
 
-            for (auto& m : m_PossibleMoves)
-                if (m.to == m_FocusedSquare.value())
-                {
-                    move = &m;
-                    break;
-                }
-
-            if (move)
+            if (target != m_PossibleMoves.end())
             {
-                m_Board.executeMove(*move);
+                // Moves come in the same order as the targets
+                Chess::Board::MoveBuffer moves;
+                m_Board.getPossibleMoves(m_SelectedSquare.value(), moves);
+
+                m_Board.executeMove(moves[target - m_PossibleMoves.begin()]);
 
                 m_SelectedSquare = std::nullopt;
-                m_PossibleMoves.clear();
+                m_PossibleMoves = {};
 
                 const Chess::Player current_player = m_Board.getCurrentTurn();
             
@@ -307,15 +360,16 @@ auto Controller::handle_action(Action action) noexcept -> void
 
         case Action::SelectPiece: {
 
-            const auto& pieces = m_Board.getPieces();
-
-            const auto piece = pieces.find(m_FocusedSquare.value());
+            {
+                const auto snapshot = m_Snapshots.read();
+                const auto piece = snapshot->pieceAt(m_FocusedSquare.value());
 
-            if (piece == pieces.end() || piece->second.color != m_Board.getCurrentTurn())
-                break;
+                if (piece == std::nullopt || piece->color != snapshot->turn)
+                    break;
+            }
 
             m_SelectedSquare = m_FocusedSquare;
-            m_PossibleMoves = m_Board.getPossibleMoves(m_SelectedSquare.value());
+            m_PossibleMoves = m_Board.getLegalMoves(m_SelectedSquare.value());
 
             break;
         }
@@ -323,18 +377,22 @@ auto Controller::handle_action(Action action) noexcept -> void
         case Action::UnselectPiece: {
 
             m_SelectedSquare = std::nullopt;
-            m_PossibleMoves.clear();
+            m_PossibleMoves = {};
 
             break;
         }
 
-        case Action::UndoMove: {
+        case Action::UndoMove:
+        case Action::RedoMove: {
 
             m_SelectedSquare = std::nullopt;
-            m_PossibleMoves.clear();
+            m_PossibleMoves = {};
             m_AttackingPieces.clear();
 
-            m_Board.undoMove();
+            if (action == Action::UndoMove)
+                m_Board.undoMove();
+            else
+                m_Board.redoMove();
 
             Chess::Player current_player = m_Board.getCurrentTurn();
             m_Board.getPiecesAttackingPos(
@@ -350,12 +408,23 @@ auto Controller::handle_action(Action action) noexcept -> void
             m_Board.reset();
 
             m_SelectedSquare = std::nullopt;
-            m_PossibleMoves.clear();
+            m_PossibleMoves = {};
             m_AttackingPieces.clear();
 
             break;
         }
 
+        case Action::DumpTrace: {
+            if (!Profiling::TracingEnabled)
+                std::cerr << "Tracing is disabled, configure with -DENABLE_TRACING=ON\n";
+            else if (Profiling::dump_trace(Profiling::DefaultTracePath))
+                std::cout << "Trace written to " << Profiling::DefaultTracePath << '\n';
+            else
+                std::cerr << "Failed to write " << Profiling::DefaultTracePath << '\n';
+
+            break;
+        }
+
         default:
             break;
     }
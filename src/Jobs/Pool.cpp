@@ -0,0 +1,317 @@
+#include "Jobs/Pool.hpp"
+
+#include <array>
+
+#include "Profiling/Trace.hpp"
+
+namespace
+{
+
+// Set on the threads of a pool, tasks they submit go to their own deque
+struct Worker
+{
+    const Jobs::Pool* pool{nullptr};
+    std::size_t index{0};
+};
+
+thread_local Worker worker;
+
+std::atomic<Jobs::Pool*> current_pool{nullptr};
+
+// Rounds of yielding and looking again before a worker goes to sleep
+constexpr int SpinRounds = 64;
+
+// Where a thief starts looking, so thieves don't all line up on the first worker
+auto random_start(const std::size_t count) -> std::size_t
+{
+    thread_local uint64_t state = std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1;
+
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    return state % count;
+}
+
+auto run(Jobs::Task& task) -> void
+{
+    task.function();
+
+    // The group may be gone right after this, the task with it
+    task.group->finish();
+}
+
+} // namespace
+
+namespace Jobs
+{
+
+// Chase-Lev work-stealing deque with a fixed capacity, after "Correct and Efficient Work-Stealing
+// for Weak Memory Models" (Le et al. 2013). A push onto a full deque fails, the owner then runs
+// the task itself.
+class Pool::Deque
+{
+    public:
+        static constexpr int64_t Capacity = 1 << 12;
+
+        // Owner only
+        auto push(Task* task) -> bool
+        {
+            const int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+            const int64_t top = m_Top.load(std::memory_order_acquire);
+
+            if (bottom - top >= Capacity)
+                return false;
+
+            m_Tasks[bottom % Capacity].store(task, std::memory_order_release);
+            std::atomic_thread_fence(std::memory_order_release);
+            m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+
+            return true;
+        }
+
+        // Owner only, the newest task
+        auto pop() -> Task*
+        {
+            const int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+            m_Bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t top = m_Top.load(std::memory_order_relaxed);
+
+            if (top > bottom)
+            {
+                m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            Task* task = m_Tasks[bottom % Capacity].load(std::memory_order_acquire);
+
+            // The last task, a thief may be taking it right now
+            if (top == bottom)
+            {
+                if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    task = nullptr;
+
+                m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+
+            return task;
+        }
+
+        // Any thread, the oldest task
+        auto steal() -> Task*
+        {
+            int64_t top = m_Top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+
+            if (top >= bottom)
+                return nullptr;
+
+            Task* task = m_Tasks[top % Capacity].load(std::memory_order_acquire);
+
+            // Another thief or the owner got it first
+            if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return nullptr;
+
+            return task;
+        }
+    private:
+        // Thieves and the owner each hammer one of them
+        alignas(64) std::atomic<int64_t> m_Top{0};
+        alignas(64) std::atomic<int64_t> m_Bottom{0};
+        std::array<std::atomic<Task*>, Capacity> m_Tasks{};
+}; // class Pool::Deque
+
+Pool::Pool(const std::size_t workers)
+{
+    for (std::size_t i = 0; i < workers; i++)
+        m_Deques.push_back(std::make_unique<Deque>());
+
+    for (std::size_t i = 0; i < workers; i++)
+        m_Workers.emplace_back(&Pool::worker_loop, this, i);
+
+    Pool* expected = nullptr;
+    current_pool.compare_exchange_strong(expected, this);
+}
+
+Pool::~Pool()
+{
+    Pool* expected = this;
+    current_pool.compare_exchange_strong(expected, nullptr);
+
+    {
+        const std::lock_guard lock{m_SleepMutex};
+        m_Stopping = true;
+    }
+
+    m_Wake.notify_all();
+
+    for (std::thread& thread : m_Workers)
+        thread.join();
+}
+
+auto Pool::workerCount() const -> std::size_t
+{
+    return m_Workers.size();
+}
+
+auto Pool::current() -> Pool*
+{
+    return current_pool.load(std::memory_order_acquire);
+}
+
+auto Pool::submit(Task& task) -> void
+{
+    if (worker.pool == this)
+    {
+        if (!m_Deques[worker.index]->push(&task))
+        {
+            run(task);
+            return;
+        }
+    }
+    else
+    {
+        const std::lock_guard lock{m_SharedMutex};
+        m_Shared.push_back(&task);
+    }
+
+    wake();
+}
+
+auto Pool::runOne() -> bool
+{
+    Task* task = take(worker.pool == this ? worker.index : m_Deques.size());
+
+    if (!task)
+        return false;
+
+    run(*task);
+
+    return true;
+}
+
+auto Pool::worker_loop(const std::size_t index) -> void
+{
+    worker = Worker{.pool = this, .index = index};
+
+    PROFILE_THREAD("worker");
+
+    while (true)
+    {
+        if (runOne())
+            continue;
+
+        bool found = false;
+
+        for (int round = 0; round < SpinRounds && !found; round++)
+        {
+            std::this_thread::yield();
+            found = runOne();
+        }
+
+        if (found)
+            continue;
+
+        // Registered as sleeping before the last look, a task submitted after it bumps the epoch
+        m_Sleeping++;
+
+        const uint64_t epoch = m_Epoch.load();
+
+        if (runOne())
+        {
+            m_Sleeping--;
+            continue;
+        }
+
+        std::unique_lock lock{m_SleepMutex};
+        m_Wake.wait(lock, [&] { return m_Stopping || m_Epoch.load() != epoch; });
+        m_Sleeping--;
+
+        if (m_Stopping)
+            return;
+    }
+}
+
+// Own deque first, newest task first, since its data is most likely still in the cache. Then the
+// tasks of threads outside the pool, then the oldest tasks of the other workers.
+auto Pool::take(const std::size_t own) -> Task*
+{
+    if (own < m_Deques.size())
+        if (Task* task = m_Deques[own]->pop())
+            return task;
+
+    {
+        const std::lock_guard lock{m_SharedMutex};
+
+        if (!m_Shared.empty())
+        {
+            Task* task = m_Shared.front();
+            m_Shared.pop_front();
+
+            return task;
+        }
+    }
+
+    if (m_Deques.empty())
+        return nullptr;
+
+    const std::size_t start = random_start(m_Deques.size());
+
+    for (std::size_t i = 0; i < m_Deques.size(); i++)
+    {
+        const std::size_t victim = (start + i) % m_Deques.size();
+
+        if (victim == own)
+            continue;
+
+        if (Task* task = m_Deques[victim]->steal())
+            return task;
+    }
+
+    return nullptr;
+}
+
+auto Pool::wake() -> void
+{
+    // Pairs with the increment of m_Sleeping: either the sleeper sees the task, or this sees
+    // the sleeper
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (m_Sleeping.load() == 0)
+        return;
+
+    {
+        const std::lock_guard lock{m_SleepMutex};
+        m_Epoch++;
+    }
+
+    m_Wake.notify_one();
+}
+
+TaskGroup::TaskGroup(Pool* pool) noexcept :
+    m_Pool{pool}
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+    wait();
+}
+
+auto TaskGroup::wait() -> void
+{
+    while (m_Pending.load(std::memory_order_acquire) > 0)
+        if (!m_Pool->runOne())
+            std::this_thread::yield();
+
+    m_Tasks.clear();
+}
+
+auto TaskGroup::finish() noexcept -> void
+{
+    m_Pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+} // namespace Jobs
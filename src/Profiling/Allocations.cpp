@@ -0,0 +1,227 @@
+#include "Profiling/Allocations.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <map>
+#include <new>
+#include <string_view>
+
+namespace
+{
+
+using Profiling::AllocationCounts;
+using Profiling::AllocationSite;
+
+// Trivial, so reading them in operator new never runs a constructor that could allocate
+thread_local AllocationCounts counts;
+// Name of the innermost NoAllocationScope of the thread
+thread_local const char* forbidden = nullptr;
+
+std::atomic<const AllocationSite*> sites{nullptr};
+
+#ifdef CHESS_TRACK_ALLOCATIONS
+
+auto count(const std::size_t size) -> void
+{
+    if (forbidden)
+    {
+        // stderr is unbuffered, printing to it doesn't allocate
+        std::fprintf(stderr, "Allocation of %zu bytes in no allocation scope %s\n", size, forbidden);
+        std::abort();
+    }
+
+    counts.allocations++;
+    counts.bytes += size;
+}
+
+// Like the default operator new: the new handler may free some memory, without one it throws
+template <typename Allocate>
+auto allocate(const std::size_t size, Allocate&& try_allocate) -> void*
+{
+    count(size);
+
+    while (true)
+    {
+        if (void* memory = try_allocate())
+            return memory;
+
+        const std::new_handler handler = std::get_new_handler();
+
+        if (!handler)
+            throw std::bad_alloc{};
+
+        handler();
+    }
+}
+
+auto allocate(const std::size_t size) -> void*
+{
+    return allocate(size, [&] { return std::malloc(size == 0 ? 1 : size); });
+}
+
+auto allocate(const std::size_t size, const std::align_val_t alignment) -> void*
+{
+    const auto align = static_cast<std::size_t>(alignment);
+    // aligned_alloc() wants a multiple of the alignment
+    const std::size_t rounded = (std::max<std::size_t>(size, 1) + align - 1) / align * align;
+
+    return allocate(size, [&] { return std::aligned_alloc(align, rounded); });
+}
+
+#endif
+
+} // namespace
+
+#ifdef CHESS_TRACK_ALLOCATIONS
+
+// Replaces every global operator new of the program, the matching deletes have to be replaced too
+// since the memory now comes from malloc()
+
+auto operator new(const std::size_t size) -> void*
+{
+    return allocate(size);
+}
+
+auto operator new[](const std::size_t size) -> void*
+{
+    return allocate(size);
+}
+
+auto operator new(const std::size_t size, const std::align_val_t alignment) -> void*
+{
+    return allocate(size, alignment);
+}
+
+auto operator new[](const std::size_t size, const std::align_val_t alignment) -> void*
+{
+    return allocate(size, alignment);
+}
+
+auto operator new(const std::size_t size, const std::nothrow_t&) noexcept -> void*
+{
+    try { return allocate(size); } catch (const std::bad_alloc&) { return nullptr; }
+}
+
+auto operator new[](const std::size_t size, const std::nothrow_t&) noexcept -> void*
+{
+    try { return allocate(size); } catch (const std::bad_alloc&) { return nullptr; }
+}
+
+auto operator new(const std::size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept -> void*
+{
+    try { return allocate(size, alignment); } catch (const std::bad_alloc&) { return nullptr; }
+}
+
+auto operator new[](const std::size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept -> void*
+{
+    try { return allocate(size, alignment); } catch (const std::bad_alloc&) { return nullptr; }
+}
+
+auto operator delete(void* memory) noexcept -> void { std::free(memory); }
+auto operator delete[](void* memory) noexcept -> void { std::free(memory); }
+auto operator delete(void* memory, std::size_t) noexcept -> void { std::free(memory); }
+auto operator delete[](void* memory, std::size_t) noexcept -> void { std::free(memory); }
+auto operator delete(void* memory, std::align_val_t) noexcept -> void { std::free(memory); }
+auto operator delete[](void* memory, std::align_val_t) noexcept -> void { std::free(memory); }
+auto operator delete(void* memory, std::size_t, std::align_val_t) noexcept -> void { std::free(memory); }
+auto operator delete[](void* memory, std::size_t, std::align_val_t) noexcept -> void { std::free(memory); }
+auto operator delete(void* memory, const std::nothrow_t&) noexcept -> void { std::free(memory); }
+auto operator delete[](void* memory, const std::nothrow_t&) noexcept -> void { std::free(memory); }
+auto operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept -> void { std::free(memory); }
+auto operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept -> void { std::free(memory); }
+
+#endif
+
+namespace Profiling
+{
+
+auto thread_allocations() -> AllocationCounts
+{
+    return counts;
+}
+
+AllocationSite::AllocationSite(const char* name) noexcept :
+    m_Name{name},
+    m_Next{sites.load()}
+{
+    while (!sites.compare_exchange_weak(m_Next, this))
+        ;
+}
+
+auto AllocationSite::add(const AllocationCounts& added) noexcept -> void
+{
+    m_Calls.fetch_add(1, std::memory_order_relaxed);
+    m_Allocations.fetch_add(added.allocations, std::memory_order_relaxed);
+    m_Bytes.fetch_add(added.bytes, std::memory_order_relaxed);
+}
+
+AllocationScope::AllocationScope(AllocationSite& site) noexcept :
+    m_Site{site},
+    m_Start{counts}
+{
+}
+
+AllocationScope::~AllocationScope()
+{
+    m_Site.add({
+        .allocations = counts.allocations - m_Start.allocations,
+        .bytes = counts.bytes - m_Start.bytes
+    });
+}
+
+NoAllocationScope::NoAllocationScope(const char* name) noexcept :
+    m_Outer{forbidden}
+{
+    forbidden = name;
+}
+
+NoAllocationScope::~NoAllocationScope()
+{
+    forbidden = m_Outer;
+}
+
+auto print_allocation_report(std::ostream& out) -> void
+{
+    struct Totals
+    {
+        uint64_t calls{0};
+        uint64_t allocations{0};
+        uint64_t bytes{0};
+    };
+
+    std::map<std::string_view, Totals> totals;
+
+    for (const AllocationSite* site = sites.load(); site; site = site->next())
+    {
+        Totals& total = totals[site->name()];
+
+        total.calls += site->calls();
+        total.allocations += site->allocations();
+        total.bytes += site->bytes();
+    }
+
+    if (totals.empty())
+        return;
+
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+
+    out << "Allocations per call:\n" << std::fixed << std::setprecision(1);
+
+    for (const auto& [name, total] : totals)
+    {
+        const double calls = static_cast<double>(std::max<uint64_t>(total.calls, 1));
+
+        out << "  " << std::left << std::setw(32) << name << std::right
+            << std::setw(10) << total.calls << " calls "
+            << std::setw(10) << total.allocations / calls << " allocations "
+            << std::setw(12) << total.bytes / calls << " bytes\n";
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+} // namespace Profiling
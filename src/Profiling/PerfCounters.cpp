@@ -0,0 +1,201 @@
+#include "Profiling/PerfCounters.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+using Profiling::PerfCounters;
+
+#ifdef __linux__
+
+struct EventConfig
+{
+    uint32_t type;
+    uint64_t config;
+};
+
+// Indexed by PerfCounters::Counter
+constexpr std::array<EventConfig, PerfCounters::CounterCount> Events = {{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D
+        | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+        | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL
+        | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+        | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)}
+}};
+
+auto open_event(const EventConfig& event) -> int
+{
+    perf_event_attr attr{};
+
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.disabled = 1;
+    // Worker threads started while counting are counted too
+    attr.inherit = 1;
+    // User space only, allowed with the default perf_event_paranoid
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+#endif
+
+} // namespace
+
+namespace Profiling
+{
+
+PerfCounters::PerfCounters()
+{
+    m_Fds.fill(-1);
+
+#ifdef __linux__
+    for (std::size_t i = 0; i < CounterCount; i++)
+    {
+        m_Fds[i] = open_event(Events[i]);
+
+        if (m_Fds[i] < 0 && m_Error.empty())
+            m_Error = std::string{"perf_event_open: "} + std::strerror(errno);
+    }
+#else
+    m_Error = "hardware counters need Linux";
+#endif
+}
+
+PerfCounters::~PerfCounters()
+{
+#ifdef __linux__
+    for (const int fd : m_Fds)
+        if (fd >= 0)
+            close(fd);
+#endif
+}
+
+auto PerfCounters::available() const -> bool
+{
+    for (const int fd : m_Fds)
+        if (fd >= 0)
+            return true;
+
+    return false;
+}
+
+auto PerfCounters::error() const -> const std::string&
+{
+    return m_Error;
+}
+
+auto PerfCounters::start() -> void
+{
+#ifdef __linux__
+    for (const int fd : m_Fds)
+    {
+        if (fd < 0)
+            continue;
+
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+auto PerfCounters::stop() -> Reading
+{
+    Reading reading;
+
+#ifdef __linux__
+    for (std::size_t i = 0; i < CounterCount; i++)
+    {
+        const int fd = m_Fds[i];
+
+        if (fd < 0)
+            continue;
+
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+        // Value, time enabled, time running
+        std::array<uint64_t, 3> data{};
+
+        if (read(fd, data.data(), sizeof(data)) != sizeof(data) || data[2] == 0)
+            continue;
+
+        reading.values[i] = static_cast<double>(data[0]) * data[1] / data[2];
+    }
+#endif
+
+    return reading;
+}
+
+auto PerfCounters::name(const Counter counter) -> const char*
+{
+    switch (counter)
+    {
+        case Counter::Cycles: return "cycles";
+        case Counter::Instructions: return "instructions";
+        case Counter::BranchMisses: return "branch misses";
+        case Counter::L1Misses: return "L1 misses";
+        case Counter::LLCMisses: return "LLC misses";
+        default: return "unknown";
+    }
+}
+
+auto print_counters(std::ostream& out, const PerfCounters& counters, const PerfCounters::Reading& reading, const uint64_t nodes) -> void
+{
+    using Counter = PerfCounters::Counter;
+
+    if (!counters.available())
+    {
+        out << "counters unavailable (" << counters.error() << ")";
+        return;
+    }
+
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+
+    out << std::fixed << std::setprecision(2);
+
+    const auto cycles = reading.get(Counter::Cycles);
+    const auto instructions = reading.get(Counter::Instructions);
+
+    if (cycles && instructions && *cycles > 0)
+        out << "IPC " << *instructions / *cycles << ", ";
+    else
+        out << "IPC n/a, ";
+
+    out << "per node:";
+
+    for (std::size_t i = 0; i < PerfCounters::CounterCount; i++)
+    {
+        const auto counter = static_cast<Counter>(i);
+        const auto value = reading.get(counter);
+
+        out << (i == 0 ? " " : ", ") << PerfCounters::name(counter) << ' ';
+
+        if (value && nodes != 0)
+            out << *value / nodes;
+        else
+            out << "n/a";
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+} // namespace Profiling
@@ -0,0 +1,377 @@
+#include "Profiling/Sampler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <link.h>
+#include <signal.h>
+#include <sys/time.h>
+#endif
+
+namespace
+{
+
+using Profiling::Sampler;
+
+// Sampler::record(), the handler and the signal trampoline, above them is the interrupted
+// function. Both are kept out of line so the count doesn't change with the optimizer.
+constexpr std::size_t SkippedFrames = 3;
+
+// Addresses per addr2line call, keeps the command line short
+constexpr std::size_t SymbolizeBatch = 256;
+
+// Read by the signal handler, which can't be handed anything else
+std::atomic<Sampler*> active{nullptr};
+// Handlers between reading active and being done with it, so stop() knows when the sampler
+// isn't used anymore
+std::atomic<int> busy{0};
+
+#ifdef __linux__
+
+auto demangle(const char* name) -> std::string
+{
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+
+    if (status != 0 || !demangled)
+        return name;
+
+    std::string result = demangled;
+    std::free(demangled);
+
+    return result;
+}
+
+auto hex(const uintptr_t value) -> std::string
+{
+    std::ostringstream out;
+    out << "0x" << std::hex << value;
+
+    return out.str();
+}
+
+struct Location
+{
+    std::string module;
+    // What addr2line expects, the offset into position independent modules
+    uintptr_t address;
+};
+
+auto locate(const void* address, Dl_info& info) -> std::optional<Location>
+{
+    if (!dladdr(address, &info) || !info.dli_fbase)
+        return std::nullopt;
+
+    const auto base = reinterpret_cast<uintptr_t>(info.dli_fbase);
+    const auto* header = static_cast<const ElfW(Ehdr)*>(info.dli_fbase);
+    const bool relocatable = header->e_type == ET_DYN;
+
+    // The executable may be named relative to a directory the process left
+    std::string module = info.dli_fname ? info.dli_fname : "";
+
+    if (module.empty() || !std::filesystem::exists(module))
+        module = "/proc/self/exe";
+
+    return Location{
+        .module = std::move(module),
+        .address = reinterpret_cast<uintptr_t>(address) - (relocatable ? base : 0)
+    };
+}
+
+// Function names of the addresses in one module, "??" where addr2line doesn't know, empty if it
+// couldn't be run at all
+auto run_addr2line(const std::string& module, const std::vector<uintptr_t>& addresses) -> std::vector<std::string>
+{
+    std::string command = "addr2line -C -f -e '" + module + "'";
+
+    for (const uintptr_t address : addresses)
+        command += " " + hex(address);
+
+    command += " 2>/dev/null";
+
+    FILE* pipe = popen(command.c_str(), "r");
+
+    if (!pipe)
+        return {};
+
+    std::vector<std::string> names;
+    std::string line;
+    std::array<char, 4096> chunk;
+    bool function_line = true;
+
+    // Two lines per address, the function and its file and line
+    while (std::fgets(chunk.data(), chunk.size(), pipe))
+    {
+        line += chunk.data();
+
+        if (line.empty() || line.back() != '\n')
+            continue;
+
+        line.pop_back();
+
+        if (function_line)
+            names.push_back(line);
+
+        function_line = !function_line;
+        line.clear();
+    }
+
+    if (pclose(pipe) != 0 || names.size() != addresses.size())
+        return {};
+
+    return names;
+}
+
+// One name per address, addr2line first since dladdr only knows exported symbols and would
+// name a static function after the exported one before it
+auto symbolize(const std::vector<void*>& addresses) -> std::map<void*, std::string>
+{
+    std::map<void*, std::string> names;
+    std::map<std::string, std::vector<std::pair<void*, uintptr_t>>> modules;
+
+    for (void* address : addresses)
+    {
+        Dl_info info{};
+        const auto location = locate(address, info);
+
+        if (info.dli_sname)
+            names[address] = demangle(info.dli_sname);
+        else if (location)
+            names[address] = std::filesystem::path{location->module}.filename().string() + "+" + hex(location->address);
+        else
+            names[address] = hex(reinterpret_cast<uintptr_t>(address));
+
+        if (location)
+            modules[location->module].emplace_back(address, location->address);
+    }
+
+    for (const auto& [module, entries] : modules)
+    for (std::size_t first = 0; first < entries.size(); first += SymbolizeBatch)
+    {
+        const std::size_t last = std::min(first + SymbolizeBatch, entries.size());
+        std::vector<uintptr_t> batch;
+
+        for (std::size_t i = first; i < last; i++)
+            batch.push_back(entries[i].second);
+
+        const std::vector<std::string> found = run_addr2line(module, batch);
+
+        // Not installed, later batches would fail the same way
+        if (found.empty())
+            break;
+
+        for (std::size_t i = first; i < last; i++)
+            if (found[i - first] != "??")
+                names[entries[i].first] = found[i - first];
+    }
+
+    return names;
+}
+
+#endif
+
+} // namespace
+
+namespace Profiling
+{
+
+Sampler::Sampler(const int frequency, const std::size_t capacity) :
+    m_Capacity{capacity},
+    m_Frames{std::make_unique<void*[]>(capacity * MaxDepth)},
+    m_Depths{std::make_unique<uint8_t[]>(capacity)}
+{
+#ifdef __linux__
+    // The first backtrace() loads the unwinder, which allocates and mustn't happen in the handler
+    std::array<void*, 4> warm_up;
+    backtrace(warm_up.data(), warm_up.size());
+
+    Sampler* expected = nullptr;
+
+    if (!active.compare_exchange_strong(expected, this))
+    {
+        m_Error = "another sampler is running";
+        return;
+    }
+
+    struct sigaction action{};
+    action.sa_handler = handle_signal;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+
+    itimerval timer{};
+    timer.it_interval.tv_usec = std::max(1000000 / std::max(frequency, 1), 1);
+    timer.it_value = timer.it_interval;
+
+    if (sigaction(SIGPROF, &action, nullptr) != 0 || setitimer(ITIMER_PROF, &timer, nullptr) != 0)
+    {
+        m_Error = std::string{"SIGPROF timer: "} + std::strerror(errno);
+        active = nullptr;
+        return;
+    }
+
+    m_Running = true;
+#else
+    static_cast<void>(frequency);
+    m_Error = "sampling needs Linux";
+#endif
+}
+
+Sampler::~Sampler()
+{
+    stop();
+}
+
+auto Sampler::available() const -> bool
+{
+    return m_Error.empty();
+}
+
+auto Sampler::error() const -> const std::string&
+{
+    return m_Error;
+}
+
+auto Sampler::stop() -> void
+{
+#ifdef __linux__
+    if (!m_Running)
+        return;
+
+    m_Running = false;
+
+    const itimerval timer{};
+    setitimer(ITIMER_PROF, &timer, nullptr);
+
+    // A signal still pending would terminate the process with the default action
+    signal(SIGPROF, SIG_IGN);
+
+    active = nullptr;
+
+    while (busy > 0)
+        std::this_thread::yield();
+#endif
+}
+
+auto Sampler::samples() const -> std::size_t
+{
+    return std::min(m_Next.load(), m_Capacity);
+}
+
+auto Sampler::dropped() const -> std::size_t
+{
+    return m_Next.load() - samples();
+}
+
+auto Sampler::writeFolded(const std::string& path) -> bool
+{
+    stop();
+
+    std::ofstream file{path};
+
+    if (!file)
+        return false;
+
+#ifdef __linux__
+    const std::size_t count = samples();
+
+    // Return addresses point after the call, one byte back is still inside the calling line.
+    // The interrupted frame has the exact address.
+    auto frame_address = [&](const std::size_t sample, const std::size_t frame) -> void*
+    {
+        auto* address = static_cast<char*>(m_Frames[sample * MaxDepth + frame]);
+
+        return frame == SkippedFrames ? address : address - 1;
+    };
+
+    std::vector<void*> addresses;
+
+    for (std::size_t sample = 0; sample < count; sample++)
+        for (std::size_t frame = SkippedFrames; frame < m_Depths[sample]; frame++)
+            addresses.push_back(frame_address(sample, frame));
+
+    std::sort(addresses.begin(), addresses.end());
+    addresses.erase(std::unique(addresses.begin(), addresses.end()), addresses.end());
+
+    const std::map<void*, std::string> names = symbolize(addresses);
+    std::map<std::string, std::size_t> stacks;
+
+    for (std::size_t sample = 0; sample < count; sample++)
+    {
+        std::string stack;
+
+        for (std::size_t frame = m_Depths[sample]; frame-- > SkippedFrames;)
+        {
+            std::string name = names.at(frame_address(sample, frame));
+            std::replace(name.begin(), name.end(), ';', ':');
+
+            stack += stack.empty() ? "" : ";";
+            stack += name;
+        }
+
+        if (!stack.empty())
+            stacks[stack]++;
+    }
+
+    for (const auto& [stack, hits] : stacks)
+        file << stack << ' ' << hits << '\n';
+#endif
+
+    return static_cast<bool>(file);
+}
+
+auto Sampler::handle_signal(const int /* signal */) -> void
+{
+    const int saved_errno = errno;
+
+    busy++;
+
+    if (Sampler* sampler = active.load())
+        sampler->record();
+
+    busy--;
+
+    errno = saved_errno;
+}
+
+// Runs in the signal handler, only lock-free atomics and backtrace() after its warm-up
+auto Sampler::record() -> void
+{
+#ifdef __linux__
+    const std::size_t index = m_Next++;
+
+    if (index >= m_Capacity)
+        return;
+
+    const int depth = backtrace(&m_Frames[index * MaxDepth], MaxDepth);
+
+    m_Depths[index] = static_cast<uint8_t>(std::max(depth, 0));
+#endif
+}
+
+auto write_profile(Sampler& sampler, const std::string& path) -> void
+{
+    if (!sampler.available())
+        std::cerr << "Sampling unavailable (" << sampler.error() << ")\n";
+    else if (!sampler.writeFolded(path))
+        std::cerr << "Failed to write " << path << '\n';
+    else
+        std::cerr << "Profile: " << sampler.samples() << " samples (" << sampler.dropped()
+            << " dropped) written to " << path << '\n';
+}
+
+} // namespace Profiling
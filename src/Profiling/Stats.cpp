@@ -0,0 +1,127 @@
+#include "Profiling/Stats.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+
+using Profiling::StatCount;
+using Profiling::StatsSnapshot;
+using Profiling::ThreadStats;
+
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<const ThreadStats*> threads;
+    // Left behind by threads that exited
+    StatsSnapshot retired;
+};
+
+auto registry() -> Registry&
+{
+    static Registry instance;
+
+    return instance;
+}
+
+// Registers the counters of a thread on its first count and folds them into the retired totals
+// when it exits
+class LocalStats
+{
+    public:
+        LocalStats()
+        {
+            Registry& shared = registry();
+            const std::lock_guard lock{shared.mutex};
+
+            shared.threads.push_back(&m_Stats);
+        }
+
+        ~LocalStats()
+        {
+            Registry& shared = registry();
+            const std::lock_guard lock{shared.mutex};
+
+            for (std::size_t i = 0; i < StatCount; i++)
+                shared.retired.values[i] += m_Stats.values[i].load(std::memory_order_relaxed);
+
+            std::erase(shared.threads, &m_Stats);
+        }
+
+        LocalStats(const LocalStats&) = delete;
+        auto operator=(const LocalStats&) -> LocalStats& = delete;
+
+        auto stats() -> ThreadStats& { return m_Stats; }
+    private:
+        ThreadStats m_Stats;
+}; // class LocalStats
+
+auto percent(const uint64_t part, const uint64_t whole) -> double
+{
+    return whole == 0 ? 0.0 : 100.0 * part / whole;
+}
+
+} // namespace
+
+namespace Profiling
+{
+
+auto local_stats() -> ThreadStats&
+{
+    thread_local LocalStats local;
+
+    return local.stats();
+}
+
+auto read_stats() -> StatsSnapshot
+{
+    Registry& shared = registry();
+    const std::lock_guard lock{shared.mutex};
+
+    StatsSnapshot snapshot = shared.retired;
+
+    for (const ThreadStats* thread : shared.threads)
+        for (std::size_t i = 0; i < StatCount; i++)
+            snapshot.values[i] += thread->values[i].load(std::memory_order_relaxed);
+
+    return snapshot;
+}
+
+auto print_stats(std::ostream& out, const StatsSnapshot& stats) -> void
+{
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+
+    out << std::fixed << std::setprecision(1);
+
+    if (const uint64_t nodes = stats.get(Stat::SearchNodes))
+    {
+        const double seconds = stats.get(Stat::SearchTime) / 1e9;
+
+        out << "Search: " << nodes << " nodes ("
+            << percent(stats.get(Stat::QuiescenceNodes), nodes) << "% quiescence), "
+            << std::setprecision(2) << (seconds > 0.0 ? nodes / seconds / 1e6 : 0.0) << " Mnps, "
+            << std::setprecision(1) << "TT hits " << percent(stats.get(Stat::TableHits), stats.get(Stat::TableProbes))
+            << "% of " << stats.get(Stat::TableProbes) << " probes, first move cutoffs "
+            << percent(stats.get(Stat::FirstMoveCutoffs), stats.get(Stat::BetaCutoffs))
+            << "% of " << stats.get(Stat::BetaCutoffs) << '\n';
+    }
+
+    if (stats.get(Stat::MovesGenerated) || stats.get(Stat::LegalityChecks))
+        out << "Board: " << stats.get(Stat::MovesGenerated) << " moves generated, "
+            << stats.get(Stat::LegalityChecks) << " legality checks\n";
+
+    if (const uint64_t frames = stats.get(Stat::Frames))
+        out << "Render: " << frames << " frames, "
+            << stats.get(Stat::FrameTime) / 1e6 / frames << " ms, "
+            << static_cast<double>(stats.get(Stat::DrawCalls)) / frames << " draw calls and "
+            << static_cast<double>(stats.get(Stat::StateChanges)) / frames << " state changes per frame\n";
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+} // namespace Profiling
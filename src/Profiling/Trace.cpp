@@ -0,0 +1,218 @@
+#include "Profiling/Trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+
+using Profiling::TraceEvent;
+
+// Events kept per thread, the oldest are overwritten first
+constexpr std::size_t RingCapacity = 1 << 14;
+
+// Written by one thread at a time, the mutex is only ever contended while a dump copies it
+struct Ring
+{
+    std::mutex mutex;
+    std::vector<TraceEvent> events = std::vector<TraceEvent>(RingCapacity);
+    uint64_t written{0};
+};
+
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Ring>> rings;
+    // Left behind by threads that exited, their events stay until a new thread overwrites them
+    std::vector<Ring*> unused;
+    std::map<uint32_t, std::string> names;
+    uint32_t nextThread{1};
+};
+
+auto registry() -> Registry&
+{
+    static Registry instance;
+
+    return instance;
+}
+
+auto now() -> uint64_t
+{
+    static const auto origin = std::chrono::steady_clock::now();
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+// Takes a ring on the first zone of a thread and hands it back when the thread exits, so the
+// threads started for a single job don't each keep one
+class LocalRing
+{
+    public:
+        LocalRing()
+        {
+            Registry& shared = registry();
+            const std::lock_guard lock{shared.mutex};
+
+            if (shared.unused.empty())
+            {
+                shared.rings.push_back(std::make_unique<Ring>());
+                m_Ring = shared.rings.back().get();
+            }
+            else
+            {
+                m_Ring = shared.unused.back();
+                shared.unused.pop_back();
+            }
+
+            m_Thread = shared.nextThread++;
+        }
+
+        ~LocalRing()
+        {
+            Registry& shared = registry();
+            const std::lock_guard lock{shared.mutex};
+
+            shared.unused.push_back(m_Ring);
+        }
+
+        LocalRing(const LocalRing&) = delete;
+        auto operator=(const LocalRing&) -> LocalRing& = delete;
+
+        auto ring() -> Ring& { return *m_Ring; }
+        auto thread() const -> uint32_t { return m_Thread; }
+    private:
+        Ring* m_Ring;
+        uint32_t m_Thread;
+}; // class LocalRing
+
+auto local_ring() -> LocalRing&
+{
+    thread_local LocalRing local;
+
+    return local;
+}
+
+auto write_string(std::ostream& out, const std::string_view text) -> void
+{
+    out << '"';
+
+    for (const char c : text)
+    {
+        if (c == '"' || c == '\\')
+            out << '\\';
+
+        out << c;
+    }
+
+    out << '"';
+}
+
+} // namespace
+
+namespace Profiling
+{
+
+TraceZone::TraceZone(const char* name) noexcept :
+    m_Name{name},
+    m_Start{now()}
+{
+}
+
+TraceZone::~TraceZone()
+{
+    const uint64_t end = now();
+
+    LocalRing& local = local_ring();
+    Ring& ring = local.ring();
+
+    const std::lock_guard lock{ring.mutex};
+
+    ring.events[ring.written++ % RingCapacity] = TraceEvent{
+        .name = m_Name,
+        .start = m_Start,
+        .duration = end - m_Start,
+        .thread = local.thread()
+    };
+}
+
+auto set_thread_name(const char* name) -> void
+{
+    const uint32_t thread = local_ring().thread();
+
+    Registry& shared = registry();
+    const std::lock_guard lock{shared.mutex};
+
+    shared.names[thread] = name;
+}
+
+auto dump_trace(const std::string& path) -> bool
+{
+    std::vector<TraceEvent> events;
+    std::map<uint32_t, std::string> names;
+
+    {
+        Registry& shared = registry();
+        const std::lock_guard lock{shared.mutex};
+
+        names = shared.names;
+
+        for (const auto& ring : shared.rings)
+        {
+            const std::lock_guard ring_lock{ring->mutex};
+            const uint64_t count = std::min<uint64_t>(ring->written, RingCapacity);
+
+            for (uint64_t i = ring->written - count; i < ring->written; i++)
+                events.push_back(ring->events[i % RingCapacity]);
+        }
+    }
+
+    std::sort(events.begin(), events.end(), [](const TraceEvent& a, const TraceEvent& b)
+    {
+        return a.start < b.start;
+    });
+
+    std::ofstream file{path};
+
+    if (!file)
+        return false;
+
+    // Complete events ("X") with microsecond times, one process
+    file << "{\"traceEvents\": [\n" << std::fixed << std::setprecision(3);
+
+    bool first = true;
+
+    for (const auto& [thread, name] : names)
+    {
+        file << (first ? "" : ",\n")
+            << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << thread
+            << ", \"args\": {\"name\": ";
+        write_string(file, name);
+        file << "}}";
+
+        first = false;
+    }
+
+    for (const TraceEvent& event : events)
+    {
+        file << (first ? "" : ",\n") << "{\"name\": ";
+        write_string(file, event.name);
+        file << ", \"ph\": \"X\", \"pid\": 1, \"tid\": " << event.thread
+            << ", \"ts\": " << event.start / 1000.0
+            << ", \"dur\": " << event.duration / 1000.0 << "}";
+
+        first = false;
+    }
+
+    file << "\n], \"displayTimeUnit\": \"ms\"}\n";
+
+    return static_cast<bool>(file);
+}
+
+} // namespace Profiling
@@ -13,11 +13,16 @@ Camera::Camera(vector position, normal forward, normal up) noexcept :
     m_up{up},
     m_right{glm::normalize(glm::cross(m_forward, m_up))}
 {
-    glEnable(GL_DEPTH_TEST);
     updateView();
     updateProjection();
 }
 
+auto Camera::setAspect(const float aspect) noexcept -> void
+{
+    m_aspect = aspect;
+    updateProjection();
+}
+
 auto Camera::move(const vector movement) noexcept -> void
 {
     const float z = movement.z;
@@ -144,13 +149,9 @@ auto Camera::updateView() noexcept -> void
 
 auto Camera::updateProjection() noexcept -> void
 {
-    // TODO: need to call it on window resize
-    int width, height;
-    glfwGetWindowSize(glfwGetCurrentContext(), &width, &height);
-
     m_projection = glm::perspective(
         glm::radians(m_fov),
-        static_cast<float>(width) / static_cast<float>(height),
+        m_aspect,
         0.5f,
         20000.f
     );
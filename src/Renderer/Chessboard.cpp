@@ -1,5 +1,7 @@
 #include "Renderer/Chessboard.hpp"
 
+#include "Profiling/Stats.hpp"
+#include "Profiling/Trace.hpp"
 #include "Common.hpp"
 
 namespace
@@ -217,6 +219,8 @@ Chessboard::Chessboard(Chess::Pos size)
 // Renders the chessboard with the given MVP matrix
 auto Chessboard::draw(const glm::mat4& MVP) -> void
 {
+    PROFILE_ZONE("Chessboard::draw");
+
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
@@ -228,6 +232,7 @@ auto Chessboard::draw(const glm::mat4& MVP) -> void
 
     m_VAO->Bind();
     glDrawArrays(GL_TRIANGLES, 0, m_VBO->GetCount() / 5);
+    Profiling::count(Profiling::Stat::DrawCalls);
 
     m_VAO->Unbind();
     m_Texture.Unbind();
@@ -19,6 +19,8 @@
 
 #include <glm/gtc/type_ptr.hpp>
 
+#include "Profiling/Stats.hpp"
+
 namespace
 {
 
@@ -154,6 +156,7 @@ Shader::~Shader() {
 }
     
 auto Shader::Bind() const -> void {
+    Profiling::count(Profiling::Stat::StateChanges);
     glUseProgram(m_id);
 }
     
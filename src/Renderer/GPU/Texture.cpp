@@ -16,6 +16,8 @@
 #include "jac/require.hpp"
 #include "jac/debug.hpp"
 
+#include "Profiling/Stats.hpp"
+
 namespace Renderer::GPU
 {
     
@@ -65,6 +67,7 @@ Texture::~Texture()
 
 auto Texture::Bind() const -> void
 {
+    Profiling::count(Profiling::Stat::StateChanges);
     glActiveTexture(GL_TEXTURE0 + m_slot);
     glBindTexture(GL_TEXTURE_2D, m_id);
 }
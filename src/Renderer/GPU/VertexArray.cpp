@@ -10,6 +10,8 @@
  */
 #include "Renderer/GPU/VertexArray.hpp"
 
+#include "Profiling/Stats.hpp"
+
 namespace Renderer::GPU
 {
     
@@ -63,6 +65,7 @@ auto VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& la
     
 auto VertexArray::Bind() const -> void
 {
+    Profiling::count(Profiling::Stat::StateChanges);
     glBindVertexArray(m_id);
 }
     
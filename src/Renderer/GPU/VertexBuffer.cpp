@@ -12,6 +12,8 @@
 
 #include <glad/gl.h>
 
+#include "Profiling/Stats.hpp"
+
 namespace Renderer::GPU
 {
     
@@ -26,6 +28,7 @@ VertexBuffer::~VertexBuffer() {
 }
     
 auto VertexBuffer::Bind() const -> void {
+    Profiling::count(Profiling::Stat::StateChanges);
     glBindBuffer(GL_ARRAY_BUFFER, m_id);
 }
     
@@ -1,13 +1,22 @@
 #include "Renderer/Renderer.hpp"
 
+#include <chrono>
 #include <map>
 #include <optional>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "Renderer/Mesh.hpp"
 #include "Renderer/UIBox.hpp"
 #include "Renderer/GPU/Shader.hpp"
 #include "Chess/Piece.hpp"
+#include "Jobs/Pool.hpp"
+#include "Profiling/Allocations.hpp"
+#include "Profiling/Stats.hpp"
+#include "Profiling/Trace.hpp"
 #include "Common.hpp"
 
 namespace
@@ -16,10 +25,20 @@ namespace
 inline auto load_meshes(const std::map<Chess::Piece::Type, std::string>& paths) ->
     std::map<Chess::Piece::Type, Renderer::Mesh>
 {
+    const std::vector<std::pair<Chess::Piece::Type, std::string>> files(paths.begin(), paths.end());
+    std::vector<Renderer::Mesh::Data> data(files.size());
+
+    // Parsed on the pool, only the upload needs the GL context of this thread
+    Jobs::parallel_for(files.size(), 1, [&](const std::size_t begin, const std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; i++)
+            data[i] = Renderer::Mesh::load(files[i].second);
+    });
+
     std::map<Chess::Piece::Type, Renderer::Mesh> meshes;
 
-    for (const auto& [type, path] : paths)
-        meshes.emplace(type, Renderer::Mesh{path});
+    for (std::size_t i = 0; i < files.size(); i++)
+        meshes.emplace(files[i].first, Renderer::Mesh{data[i]});
 
     return meshes;
 }
@@ -152,6 +171,7 @@ auto draw_rect(
     vao.Bind();
     
     glDrawArrays(GL_TRIANGLES, 0, 6);
+    Profiling::count(Profiling::Stat::DrawCalls);
 
     vao.Unbind();
 
@@ -184,16 +204,31 @@ auto draw_game_over_screen(const Controller::GameState state, const float alpha)
 namespace Renderer
 {
 
-Renderer::Renderer(const Chess::Board& board, const Controller::Controller& controller)
-    : m_Board{board},
-    m_Controller{controller},
-    m_BoardMesh{std::make_unique<Chessboard>(board.getSize())}
+Renderer::Renderer(const Chess::Board& board)
+    : m_BoardMesh{std::make_unique<Chessboard>(board.getSize())}
 {
     glEnable(GL_DEPTH_TEST);
 }
 
-auto Renderer::render(const glm::mat4& projView, GLFWwindow* window) const -> void
+auto Renderer::render(const Controller::FrameState& frame, GLFWwindow* window) const -> void
 {
+    PROFILE_ZONE("Renderer::render");
+    // Once per frame
+    PROFILE_ALLOCATIONS("Renderer::render");
+
+    const auto start = std::chrono::steady_clock::now();
+
+    int width, height;
+    glfwGetWindowSize(window, &width, &height);
+
+    // The window may have been resized since the frame was published
+    Camera camera = frame.camera;
+
+    if (width > 0 && height > 0)
+        camera.setAspect(static_cast<float>(width) / static_cast<float>(height));
+
+    const glm::mat4 projView = camera.getProjection() * camera.getView();
+
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     // Draw background
@@ -203,55 +238,49 @@ auto Renderer::render(const glm::mat4& projView, GLFWwindow* window) const -> vo
     // Draw chessboard
     m_BoardMesh->draw(projView);
 
-    // Draw pieces
-    for (const auto& [pos, piece] : m_Board.getPieces())
+    // Draw pieces, already grouped so the same model is drawn in a row
+    for (const auto& [pos, piece] : frame.pieces)
         draw_piece(projView, pos, piece);
 
     // Draw focused square
-    const std::optional<Chess::Pos>& focused = m_Controller.getFocusedPiece();
+    const std::optional<Chess::Pos>& focused = frame.focused;
 
     if (focused)
         draw_rect(projView, *focused, {0.1f, 0.9f, 0.1f, 1.0f});
 
     // Draw selected square
-    const std::optional<Chess::Pos>& selected = m_Controller.getSelectedPiece();
+    const std::optional<Chess::Pos>& selected = frame.selected;
 
     if (selected && (!focused || *selected != *focused))
         draw_rect(projView, *selected, {0.9f, 1.0f, 0.0f, 0.8f});
 
     // Draw possible moves
-    for (const auto& move : m_Controller.getPossibleMoves())
-        if (!focused || move.to != *focused)
-            draw_rect(projView, move.to, {0.0f, 0.8f, 0.1f, 0.8f});
+    for (const Chess::Pos to : frame.possibleMoves)
+        if (!focused || to != *focused)
+            draw_rect(projView, to, {0.0f, 0.8f, 0.1f, 0.8f});
 
     // Draw pieces attacking king
-    for (const auto& pos : m_Controller.getAttackingPieces())
+    for (const auto& pos : frame.attackingPieces)
         draw_rect(projView, pos, {0.8f, 0.0f, 0.1f, 0.8f});
 
     // Draw game over screen
-    static double game_over_start = 0.0;
-    static double game_over_timer = 0.0;
-
     using Controller::GameState;
-    const GameState state = m_Board.getCurrentGameState();
 
-    if (state != GameState::Playing)
+    if (frame.state != GameState::Playing)
     {
-        if (game_over_start == 0.0)
-            game_over_start = glfwGetTime();
-
-        game_over_timer = glfwGetTime() - game_over_start;
+        const double game_over_timer = glfwGetTime() - frame.gameOverTime;
 
         const float fade_time_s = 2.5f;
         const float alpha = std::min(0.975f, static_cast<float>(game_over_timer) / fade_time_s);
 
-        draw_game_over_screen(state, alpha);
-    } else
-    {
-        game_over_start = 0.0;
-        game_over_timer = 0.0;
+        draw_game_over_screen(frame.state, alpha);
     }
-    
+
+    // Without the swap, which waits for the display
+    Profiling::count(Profiling::Stat::Frames);
+    Profiling::count(Profiling::Stat::FrameTime, std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+
     glfwSwapBuffers(window);
 }
 
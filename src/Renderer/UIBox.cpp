@@ -7,6 +7,7 @@
 #include "Renderer/GPU/IndexBuffer.hpp"
 #include "Renderer/GPU/VertexBuffer.hpp"
 #include "Renderer/GPU/VertexBufferLayout.hpp"
+#include "Profiling/Stats.hpp"
 
 namespace
 {
@@ -81,6 +82,7 @@ auto UIBox::draw(const Settings& settings) const -> void
     glDisable(GL_DEPTH_TEST);
 
     glDrawArrays(GL_TRIANGLES, 0, 6);
+    Profiling::count(Profiling::Stat::DrawCalls);
 
     glEnable(GL_DEPTH_TEST);
 
@@ -1,17 +1,31 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <format>
 #include <iostream>
 #include <memory>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
 
-#include "Renderer/Camera.hpp"
-
 #include "Renderer/Renderer.hpp"
 
 #include "Chess/Board.hpp"
+#include "Chess/Cpu.hpp"
 
 #include "Controller/Controller.hpp"
 
+#include "Jobs/Pool.hpp"
+
+#include "Profiling/Allocations.hpp"
+#include "Profiling/Sampler.hpp"
+#include "Profiling/Stats.hpp"
+#include "Profiling/Trace.hpp"
+
 auto init_glfw() -> void
 {
     if (!glfwInit())
@@ -79,19 +93,71 @@ auto init_glad() -> void
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
 
+// Frame and board costs since the last update, the window has no text overlay of its own
+auto update_title(GLFWwindow* window, const Profiling::StatsSnapshot& stats, const double seconds) -> void
+{
+    using Profiling::Stat;
+
+    const uint64_t frames = std::max<uint64_t>(stats.get(Stat::Frames), 1);
+
+    const std::string title = std::format(
+        "3DChess | {:.0f} fps, {:.2f} ms, {} draw calls, {} state changes per frame | {} moves generated, {} legality checks",
+        stats.get(Stat::Frames) / seconds,
+        stats.get(Stat::FrameTime) / 1e6 / frames,
+        stats.get(Stat::DrawCalls) / frames,
+        stats.get(Stat::StateChanges) / frames,
+        stats.get(Stat::MovesGenerated),
+        stats.get(Stat::LegalityChecks));
+
+    glfwSetWindowTitle(window, title.c_str());
+}
+
 void* func = nullptr;
 void* arg = nullptr;
 
 auto main(int argc, char** argv) -> int
 {
-    if (argc != 1 && argc != 2)
+    std::vector<std::string_view> args(argv + 1, argv + argc);
+
+    // Folded stacks of the whole session, written to profile.folded on exit
+    std::optional<Profiling::Sampler> sampler;
+
+    if (const auto option = std::find(args.begin(), args.end(), "--sample"); option != args.end())
+    {
+        args.erase(option);
+        sampler.emplace();
+    }
+
+    // The best kernels the CPU supports, before any thread can call them
+    Chess::init_isa_level();
+
+    // Forces an instruction set level for the move generation and search kernels
+    if (const auto option = std::find(args.begin(), args.end(), "--isa"); option != args.end())
+    {
+        const std::optional<Chess::IsaLevel> level = option + 1 == args.end()
+            ? std::nullopt
+            : Chess::parse_isa_level(*(option + 1));
+
+        if (!level || !Chess::set_isa_level(*level))
+        {
+            std::cerr << "Unknown or unsupported instruction set level" << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+
+        args.erase(option, option + 2);
+    }
+
+    if (args.size() > 1)
     {
-        std::cout << "Usage: " << argv[0] << " <path-to-config>\n";
+        std::cout << "Usage: " << argv[0] << " [--sample] [--isa <scalar|sse4.2|avx2|avx512>] <path-to-config>\n";
         std::cout << "  ex.  " << argv[0] << " res/boards/standard.cfg" << std::endl;
 
         std::exit(EXIT_FAILURE);
     }
 
+    // Outlives everything below, mesh loading and the move filtering of big boards use it
+    const Jobs::Pool pool;
+
     std::unique_ptr<GLFWwindow, decltype(&glfwDestroyWindow)> window{create_window(), glfwDestroyWindow};
     init_glad();
 
@@ -100,23 +166,65 @@ auto main(int argc, char** argv) -> int
         glViewport(0, 0, width, height);
     });
 
-    Chess::Board board{argc == 2 ? argv[1] : "res/boards/standard.cfg"};
-
-    Renderer::Camera camera;
+    Chess::Board board{args.empty() ? "res/boards/standard.cfg" : args.front()};
 
     Controller::Controller controller{
-        camera, board, window.get()
+        board, window.get()
     };
 
-    Renderer::Renderer renderer{board, controller};
+    Renderer::Renderer renderer{board};
+
+    // Game logic runs on its own thread, a slow move never stalls a frame. GLFW events can only
+    // be polled here on the main thread, so input is captured here and handed over.
+    std::atomic<bool> running{true};
+
+    PROFILE_THREAD("main");
+
+    std::thread logic{[&]
+    {
+        PROFILE_THREAD("logic");
+
+        while (running)
+            controller.update();
+    }};
 
+    Profiling::StatsSnapshot last_stats = Profiling::read_stats();
+    auto last_title = std::chrono::steady_clock::now();
 
     while (!glfwWindowShouldClose(window.get()))
     {
-        controller.update();
-        renderer.render(camera.getProjection() * camera.getView(), window.get());
+        glfwPollEvents();
+        controller.captureInput();
 
+        renderer.render(controller.getFrame(), window.get());
+
+        const auto now = std::chrono::steady_clock::now();
+        const double elapsed = std::chrono::duration<double>(now - last_title).count();
+
+        if (elapsed >= 1.0)
+        {
+            const Profiling::StatsSnapshot stats = Profiling::read_stats();
+
+            update_title(window.get(), stats - last_stats, elapsed);
+
+            last_stats = stats;
+            last_title = now;
+        }
     }
 
+    running = false;
+    logic.join();
+
+    if (Profiling::TracingEnabled && !Profiling::dump_trace(Profiling::DefaultTracePath))
+        std::cerr << "Failed to write " << Profiling::DefaultTracePath << std::endl;
+
+    if (sampler)
+        Profiling::write_profile(*sampler);
+
+    Profiling::print_stats(std::cout, Profiling::read_stats());
+
+    // Renderer::render is per frame, Board::executeMove per move
+    Profiling::print_allocation_report(std::cout);
+
     return 0;
 };
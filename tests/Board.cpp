@@ -0,0 +1,214 @@
+#include "Tests.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "Chess/Board.hpp"
+
+namespace
+{
+
+// Legal moves of the side to move, pieces in the order of their lists
+auto legal_moves(Chess::Board& board) -> std::vector<Chess::Move>
+{
+    std::vector<Chess::Move> moves;
+
+    const Chess::Player color = board.getCurrentTurn();
+    Chess::Board::MoveBuffer buffer;
+
+    for (int type = 0; type < Chess::PieceLists::KindCount / 2; type++)
+    {
+        const auto list = board.getPieceLists().get(color, static_cast<Chess::Piece::Type>(type));
+        const std::vector<Chess::Pos> positions(list.begin(), list.end());
+
+        for (const Chess::Pos from : positions)
+        {
+            buffer.clear();
+            board.getPossibleMoves(from, buffer);
+            moves.insert(moves.end(), buffer.begin(), buffer.end());
+        }
+    }
+
+    return moves;
+}
+
+// What a ply of the game looks like to a player, compared after undo and redo
+struct PlyState
+{
+    // Targets of every square, in square order
+    std::vector<std::vector<Chess::Pos>> targets;
+    // (x, y, color, type, moved) of every piece, sorted
+    std::vector<std::tuple<int, int, int, int, bool>> pieces;
+    std::vector<uint8_t> flags;
+
+    auto operator==(const PlyState&) const -> bool = default;
+};
+
+auto record(Chess::Board& board) -> PlyState
+{
+    PlyState state;
+
+    const Chess::Pos size = board.getSize();
+
+    for (int y = 0; y < size.y; y++)
+    for (int x = 0; x < size.x; x++)
+    {
+        const auto targets = board.getLegalMoves(Chess::Pos{x, y});
+        state.targets.emplace_back(targets.begin(), targets.end());
+    }
+
+    for (const auto& [pos, piece] : board.getPieces())
+        state.pieces.emplace_back(pos.x, pos.y, static_cast<int>(piece.color), static_cast<int>(piece.type), piece.moved);
+
+    std::sort(state.pieces.begin(), state.pieces.end());
+
+    for (const Chess::Move& move : board.getMoveHistory())
+        state.flags.push_back(move.type);
+
+    return state;
+}
+
+auto fail(const std::string_view config, const std::size_t ply, const std::string_view what) -> bool
+{
+    std::cerr << config << ", ply " << ply << ": " << what << std::endl;
+
+    return false;
+}
+
+auto compare_filtering(const std::string_view config, const std::size_t plies, const uint64_t seed) -> bool
+{
+    using Filtering = Chess::Board::Filtering;
+
+    Chess::Board serial{config};
+    Chess::Board parallel{config};
+
+    serial.setFiltering(Filtering::Serial);
+    parallel.setFiltering(Filtering::Parallel);
+
+    std::mt19937_64 random{seed};
+
+    for (std::size_t ply = 0; ply < plies; ply++)
+    {
+        const auto serial_targets = serial.getLegalMoves();
+        const auto parallel_targets = parallel.getLegalMoves();
+
+        if (!std::equal(serial_targets.begin(), serial_targets.end(), parallel_targets.begin(), parallel_targets.end()))
+            return fail(config, ply, "legal targets differ");
+
+        if (serial.getCurrentGameState() != parallel.getCurrentGameState())
+            return fail(config, ply, "game states differ");
+
+        const std::vector<Chess::Move> moves = legal_moves(serial);
+
+        if (moves.empty())
+            break;
+
+        const Chess::Move& move = moves[random() % moves.size()];
+
+        serial.executeMove(move);
+        parallel.executeMove(move);
+    }
+
+    return true;
+}
+
+// Plays the game forward, recording every ply, then walks it back and forth
+auto check_history(const std::string_view config, const std::size_t plies, const uint64_t seed) -> bool
+{
+    Chess::Board board{config};
+    std::mt19937_64 random{seed};
+
+    std::vector<PlyState> recorded{record(board)};
+
+    for (std::size_t ply = 0; ply < plies; ply++)
+    {
+        const std::vector<Chess::Move> moves = legal_moves(board);
+
+        if (moves.empty())
+            return fail(config, ply, "game ended before the ply cache wrapped, pick another seed");
+
+        board.executeMove(moves[random() % moves.size()]);
+        recorded.push_back(record(board));
+    }
+
+    for (std::size_t ply = plies; ply > 0; ply--)
+    {
+        board.undoMove();
+
+        if (record(board) != recorded[ply - 1])
+            return fail(config, ply - 1, "differs after undo");
+    }
+
+    for (std::size_t ply = 1; ply <= plies; ply++)
+    {
+        if (!board.redoMove())
+            return fail(config, ply, "nothing to redo");
+
+        if (record(board) != recorded[ply])
+            return fail(config, ply, "differs after redo");
+    }
+
+    if (board.redoMove())
+        return fail(config, plies, "redo past the end of the game");
+
+    // Jumps back and forth over the whole game cross the checkpoints both ways
+    for (int jump = 0; jump < 200; jump++)
+    {
+        const std::size_t ply = random() % (plies + 1);
+
+        if (!board.jumpToPly(ply))
+            return fail(config, ply, "jump refused");
+
+        if (record(board) != recorded[ply])
+            return fail(config, ply, "differs after a jump");
+    }
+
+    if (board.jumpToPly(plies + 1))
+        return fail(config, plies + 1, "jump past the end of the game");
+
+    board.jumpToPly(plies);
+
+    // A different move after an undo starts a new line, the undone moves are gone
+    const std::size_t branch = plies / 2;
+
+    while (board.getMoveHistory().size() > branch)
+        board.undoMove();
+
+    board.executeMove(legal_moves(board).back());
+
+    if (board.redoMove())
+        return fail(config, branch, "undone moves kept after a new move");
+
+    board.reset();
+
+    if (record(board) != recorded[0])
+        return fail(config, 0, "differs after a reset");
+
+    return true;
+}
+
+} // namespace
+
+namespace Tests
+{
+
+auto filtering_matches_serial() -> bool
+{
+    return compare_filtering("res/boards/big.cfg", 200, 7)
+        && compare_filtering("res/boards/huge.cfg", 200, 7);
+}
+
+auto history_restores_plies() -> bool
+{
+    static_assert(Chess::Board::PlyCacheSize < 150, "the game has to wrap the ply cache");
+
+    return check_history("res/boards/standard.cfg", 150, 7)
+        && check_history("res/boards/big.cfg", 150, 7);
+}
+
+} // namespace Tests
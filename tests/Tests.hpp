@@ -0,0 +1,15 @@
+#pragma once
+
+namespace Tests
+{
+
+// Defined in tests/Board.cpp, each plays fixed-seed games and returns false on the first mismatch
+
+// Serial and parallel filtering give the same targets, in the same order, and the same game state
+auto filtering_matches_serial() -> bool;
+// Undoing, redoing and jumping through a game past the ply cache gives back the legal moves,
+// pieces and move flags of every ply, a new move after an undo drops the undone ones and a reset
+// goes back to the start
+auto history_restores_plies() -> bool;
+
+} // namespace Tests
@@ -0,0 +1,54 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+
+#include "Chess/Arena.hpp"
+#include "Chess/Board.hpp"
+#include "Chess/Cpu.hpp"
+#include "Chess/Position.hpp"
+#include "Profiling/Allocations.hpp"
+
+// Built with its own copy of the libraries, so ASSERT_NO_ALLOCATIONS isn't compiled out
+static_assert(Profiling::AllocationTrackingEnabled, "the allocation test needs CHESS_TRACK_ALLOCATIONS");
+
+namespace
+{
+
+// Any allocation in the perft aborts the test with the name of the scope it happened in
+auto perft_without_allocations(const std::string_view config, const int depth, const uint64_t expected) -> bool
+{
+    const Chess::Board board{config};
+
+    const uint64_t nodes = Chess::visit_position(board, [&](const auto& root)
+    {
+        ASSERT_NO_ALLOCATIONS("perftCopyMake");
+
+        return Chess::perftCopyMake(root, depth);
+    });
+
+    if (nodes != expected)
+    {
+        std::cerr << config << ": perft " << depth << " gave " << nodes << " nodes, expected " << expected << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace
+
+auto main() -> int
+{
+    Chess::init_isa_level();
+
+    // The thread's arena takes its buffer once, on first use, perft only allocates from it after that
+    Chess::Arena::local();
+
+    const bool passed = perft_without_allocations("res/boards/standard.cfg", 4, 197281)
+        && perft_without_allocations("res/boards/big.cfg", 3, 33748);
+
+    std::cout << (passed ? "PASS " : "FAIL ") << "no_allocations\n";
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,67 @@
+#include <array>
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+
+#include "Tests.hpp"
+
+#include "Chess/Cpu.hpp"
+#include "Chess/Magic.hpp"
+#include "Jobs/Pool.hpp"
+
+namespace
+{
+
+struct Test
+{
+    std::string_view name;
+    auto (*run)() -> bool;
+};
+
+// Every test is registered with ctest by name in CMakeLists.txt
+const std::array AllTests = {
+    // Magic and, where the CPU has BMI2, PEXT lookups against walking the rays
+    Test{"slider_attacks", Chess::validate_slider_attacks},
+    // Fixed-seed games on big.cfg and huge.cfg, both filtering modes ply by ply
+    Test{"filtering", Tests::filtering_matches_serial},
+    // 150 plies undone to the start, redone to the end and jumped through, then a new move after
+    // an undo and a reset
+    Test{"history", Tests::history_restores_plies}
+};
+
+} // namespace
+
+// Runs the named test, or all of them without a name, and fails if any of them does
+auto main(int argc, char** argv) -> int
+{
+    const std::string_view filter = argc > 1 ? argv[1] : "";
+
+    Chess::init_isa_level();
+
+    // For the parallel filtering, with at least one worker besides this thread
+    const Jobs::Pool pool;
+
+    bool found = false;
+    bool passed = true;
+
+    for (const Test& test : AllTests)
+    {
+        if (!filter.empty() && test.name != filter)
+            continue;
+
+        found = true;
+
+        const bool result = test.run();
+        passed = passed && result;
+
+        std::cout << (result ? "PASS " : "FAIL ") << test.name << '\n';
+    }
+
+    if (!found)
+    {
+        std::cerr << "Unknown test " << filter << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}